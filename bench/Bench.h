@@ -0,0 +1,135 @@
+// Bench.h
+// Small microbenchmark harness shared by the bench/ programs. Each benchmark times batches of operations and reports
+// ns/op ( the mean ), the 50th / 90th / 99th percentile batch in ns/op, and heap allocations per op, counted by
+// replacing the global operator new. Include it in exactly one file per program.
+//
+// Usage of a program built on it: <bench> [--json file] [--filter text] [--seconds s]
+//   --json file   Also write the results as JSON, for comparing against a baseline
+//   --filter text Only run benchmarks whose name contains text
+//   --seconds s   Time spent measuring each benchmark, default 0.5
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+inline std::atomic<long long> allocations{0}; // Every operator new since the program started 
+
+struct Result{
+    std::string name;
+    long long ops=0;
+    double nsPerOp=0.0;
+    double p50=0.0, p90=0.0, p99=0.0; // Batch percentiles, ns/op 
+    double allocsPerOp=0.0;
+};
+
+class Harness{
+
+public:
+
+    Harness(const char* programName,int argc,char** argv) : program(programName){
+        for (int i=1;i+1<argc;i+=2){
+            if (std::strcmp(argv[i],"--json")==0) jsonPath=argv[i+1];
+            else if (std::strcmp(argv[i],"--filter")==0) filter=argv[i+1];
+            else if (std::strcmp(argv[i],"--seconds")==0) seconds=std::atof(argv[i+1]);
+        }
+        std::printf("%-28s %12s %10s %10s %10s %10s\n","benchmark","ns/op","p50","p90","p99","allocs/op");
+    }
+
+    // Times op(i) for i in 0..batch-1 as one batch, over and over. setup(i) runs before each batch for every i, untimed,
+    // so each op can start from a prepared state, i.e. a position to apply a move to 
+    // name -- Benchmark name 
+    // batch -- Ops per timed batch, enough that a batch takes well over the clock's resolution 
+    template<class Setup,class Op>
+    void run(const std::string& name,int batch,Setup setup,Op op){
+
+        if (!filter.empty() && name.find(filter)==std::string::npos) return;
+        using Clock=std::chrono::steady_clock;
+
+        for (int i=0;i<batch;i++) setup(i); // Warm up 
+        for (int i=0;i<batch;i++) op(i);
+
+        std::vector<double> samples;
+        long long allocated=0;
+        double total=0.0;
+        auto end=Clock::now()+std::chrono::duration<double>(seconds);
+        while (samples.size()<10 || (Clock::now()<end && samples.size()<1000000)){
+            for (int i=0;i<batch;i++) setup(i);
+            long long before=allocations.load(std::memory_order_relaxed);
+            auto start=Clock::now();
+            for (int i=0;i<batch;i++) op(i);
+            double ns=std::chrono::duration<double,std::nano>(Clock::now()-start).count();
+            allocated+=allocations.load(std::memory_order_relaxed)-before;
+            total+=ns;
+            samples.push_back(ns/batch);
+        }
+
+        Result result;
+        result.name=name;
+        result.ops=static_cast<long long>(samples.size())*batch;
+        result.nsPerOp=total/result.ops;
+        result.allocsPerOp=static_cast<double>(allocated)/result.ops;
+        std::sort(samples.begin(),samples.end());
+        auto percentile=[&](double p){ return samples[static_cast<std::size_t>(p*(samples.size()-1))]; };
+        result.p50=percentile(0.50);
+        result.p90=percentile(0.90);
+        result.p99=percentile(0.99);
+        std::printf("%-28s %12.1f %10.1f %10.1f %10.1f %10.2f\n",name.c_str(),result.nsPerOp,result.p50,result.p90,result.p99,result.allocsPerOp);
+        results.push_back(result);
+
+    }
+
+    // -- Writes the JSON file if one was asked for, returns the program's exit code 
+    int finish() const{
+
+        if (jsonPath.empty()) return 0;
+        std::FILE* out=std::fopen(jsonPath.c_str(),"w");
+        if (!out){
+            std::fprintf(stderr,"%s: can't write %s\n",program,jsonPath.c_str());
+            return 1;
+        }
+        std::fprintf(out,"{\n  \"program\": \"%s\",\n  \"results\": [\n",program);
+        for (std::size_t i=0;i<results.size();i++){
+            const Result& r=results[i];
+            std::fprintf(out,"    {\"name\": \"%s\", \"ops\": %lld, \"ns_per_op\": %.2f, \"p50\": %.2f, \"p90\": %.2f, \"p99\": %.2f, \"allocs_per_op\": %.3f}%s\n",
+                r.name.c_str(),r.ops,r.nsPerOp,r.p50,r.p90,r.p99,r.allocsPerOp,i+1<results.size() ? "," : "");
+        }
+        std::fprintf(out,"  ]\n}\n");
+        return std::fclose(out)==0 ? 0 : 1;
+
+    }
+
+private:
+
+    const char* program;
+    std::string jsonPath;
+    std::string filter;
+    double seconds=0.5;
+    std::vector<Result> results;
+
+};
+
+}
+
+// Counting replacements for the global allocation functions, the rest of the new / delete family forwards to these 
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // malloc / free are the matching pair here 
+#endif
+void* operator new(std::size_t size){
+    bench::allocations.fetch_add(1,std::memory_order_relaxed);
+    if (void* p=std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p,std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p,std::size_t) noexcept { std::free(p); }
@@ -0,0 +1,60 @@
+// analysis.cpp
+// Render loop stand in for the AnalysisWorker: runs frames at 140 per second for a few seconds, making a move every
+// half second, and reports how long the loop's own hint work takes per frame and how long each move waits for its
+// first hint. Usage: analysis [seconds]
+
+#include "AnalysisWorker.h"
+#include "Game.h"
+#include "TimingStats.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+
+int main(int argc,char** argv){
+
+    double seconds=argc>1 ? std::atof(argv[1]) : 5.0;
+    using Clock=std::chrono::steady_clock;
+    const auto framePeriod=std::chrono::microseconds(1000000/140);
+
+    Game game;
+    game.dealNewGame(11);
+    std::mt19937 rng(11);
+    AnalysisWorker analysis;
+    std::uint64_t analysedRevision=0;
+    TimingStats frameWork;
+    long long framesWithHint=0, frames=0;
+
+    auto end=Clock::now()+std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    auto nextFrame=Clock::now();
+    while (Clock::now()<end){
+        if (frames%70==69){ // The player moves 
+            Game::MoveBuffer moves;
+            int count=game.generateMoves(moves);
+            if (count==0) game.dealNewGame(rng());
+            else game.applyMove(moves[rng()%count]);
+        }
+
+        auto start=Clock::now();
+        if (game.getRevision()!=analysedRevision){
+            analysedRevision=game.getRevision();
+            analysis.submit(game.getState(),analysedRevision);
+        }
+        Move hint;
+        if (analysis.suggestedMove(game,hint)) framesWithHint++;
+        frameWork.add(std::chrono::duration<double>(Clock::now()-start).count());
+        frames++;
+
+        nextFrame+=framePeriod;
+        std::this_thread::sleep_until(nextFrame);
+    }
+
+    TimingStats latency=analysis.latency();
+    std::cout << frames << " frames, " << framesWithHint << " showing a hint\n";
+    std::cout << "hint work per frame us  p50 " << frameWork.percentile(0.5)*1e6 << "  p99 " << frameWork.percentile(0.99)*1e6
+              << "  max " << frameWork.max()*1e6 << "\n";
+    std::cout << "move to first hint ms   p50 " << latency.percentile(0.5)*1000.0 << "  p90 " << latency.percentile(0.9)*1000.0
+              << "  p99 " << latency.percentile(0.99)*1000.0 << "  ( " << latency.count() << " positions )\n";
+    return 0;
+}
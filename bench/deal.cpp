@@ -0,0 +1,30 @@
+// deal.cpp
+// Bulk deal generation, reports deals/sec for GameState::dealt and Game::dealNewGame
+
+#include "Game.h"
+#include "GameState.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+int main(){
+
+    const std::uint64_t stateDeals=2000000;
+    std::uint64_t checksum=0; // Keeps the compiler from dropping the work 
+    auto start=std::chrono::steady_clock::now();
+    for (std::uint64_t n=1;n<=stateDeals;n++) checksum+=GameState::dealt(n).cards[51];
+    double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    std::cout << "GameState::dealt:   " << stateDeals/seconds/1e6 << " M deals/sec, " << seconds*1e9/stateDeals << " ns/deal\n";
+
+    const std::uint64_t gameDeals=500000;
+    Game game;
+    start=std::chrono::steady_clock::now();
+    for (std::uint64_t n=1;n<=gameDeals;n++){
+        game.dealNewGame(n);
+        checksum+=game.getTableau(6).size();
+    }
+    seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    std::cout << "Game::dealNewGame:  " << gameDeals/seconds/1e6 << " M deals/sec, " << seconds*1e9/gameDeals << " ns/deal\n";
+
+    return checksum==0 ? 1 : 0;
+}
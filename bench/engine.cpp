@@ -0,0 +1,109 @@
+// engine.cpp
+// Rules engine microbenchmarks on the Bench.h harness: dealing, stock cycles, applyMove for each kind of move, undo
+// and auto complete
+// Usage: engine [--json file] [--filter text] [--seconds s]
+
+#include "Bench.h"
+#include "Game.h"
+#include "GameState.h"
+#include "Notation.h"
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A position and a legal move in it 
+struct Sample{
+    GameState state;
+    std::string move;
+};
+
+// -- Kind of a move, i.e. "t>t run" when it moves more than one Tableau card 
+std::string moveKind(const Game& game,const Move& move,const std::string& text){
+    if (text=="draw" || text=="recycle") return text;
+    std::string kind;
+    kind+=text[0];
+    kind+=">";
+    kind+=text[text.find('>')+1];
+    if (move.getStartingPosition()==Location::Tableau
+        && move.getCard().getTableauIndex()+1<static_cast<int>(game.getTableau(move.getStartingPile()).size())) kind+=" run";
+    return kind;
+}
+
+}
+
+int main(int argc,char** argv){
+
+    bench::Harness harness("engine",argc,argv);
+    const int batch=64;
+
+    // Positions for every kind of move, from random play on fixed deals so every run measures the same thing 
+    const std::array<std::string,9> kinds={"draw","recycle","w>t","w>f","t>t","t>t run","t>f","f>t","undo"};
+    std::vector<std::vector<Sample>> samples(kinds.size());
+    std::mt19937 rng(2024);
+    Game::MoveBuffer moves;
+    for (std::uint64_t deal=1;deal<=400;deal++){
+        Game game;
+        game.dealNewGame(deal);
+        for (int step=0;step<300;step++){
+            int count=game.generateMoves(moves);
+            if (count==0) break;
+            for (int i=0;i<count;i++){
+                std::string text=formatMove(moves[i]);
+                std::string kind=moveKind(game,moves[i],text);
+                for (std::size_t k=0;k<kinds.size();k++){
+                    if ((kinds[k]==kind || kinds[k]=="undo") && samples[k].size()<256) samples[k].push_back({game.getState(),text});
+                }
+            }
+            game.applyMove(moves[rng()%count]);
+        }
+    }
+
+    std::vector<Game> games(batch);
+    std::vector<Move> prepared(batch);
+    std::uint64_t seed=1;
+
+    harness.run("dealNewGame",batch,[](int){},[&](int i){ games[i].dealNewGame(seed++); });
+
+    harness.run("draw x24 + resetStockpile",batch,
+        [&](int i){ games[i].setState(GameState::dealt(seed++)); },
+        [&](int i){
+            while (!games[i].getReserve().empty()) games[i].dealFromReserve();
+            games[i].resetStockpile();
+        });
+
+    for (std::size_t k=0;k<kinds.size();k++){
+        if (samples[k].empty()) continue;
+        std::size_t next=0;
+        auto prepare=[&](int i){
+            const Sample& sample=samples[k][next++%samples[k].size()];
+            games[i].setState(sample.state);
+            parseMove(games[i],sample.move,prepared[i]);
+        };
+        if (kinds[k]=="undo"){
+            harness.run("undo",batch,[&](int i){ prepare(i); games[i].applyMove(prepared[i]); },[&](int i){ games[i].undo(); });
+        } else {
+            harness.run("applyMove "+kinds[k],batch,prepare,[&](int i){ games[i].applyMove(prepared[i]); });
+        }
+    }
+
+    // Settle each position first so only what the move itself changed is left to look at, as after a player's move 
+    std::size_t next=0;
+    harness.run("applyMove + autoComplete",batch,
+        [&](int i){
+            const Sample& sample=samples.back()[next++%samples.back().size()];
+            games[i].setState(sample.state);
+            games[i].autoComplete();
+            int count=games[i].generateMoves(moves);
+            prepared[i]=count>0 ? moves[rng()%count] : Move();
+        },
+        [&](int i){
+            games[i].applyMove(prepared[i]);
+            games[i].autoComplete();
+        });
+
+    return harness.finish();
+}
@@ -0,0 +1,107 @@
+// frame.cpp
+// Front-end microbenchmarks on the Bench.h harness: a full frame of SolitaireGraphics::draw, and Input's per frame mouse
+// handling, both into an offscreen target so no window is needed. Needs SFML and the assets folder, run it from the
+// repository root. GPU work is asynchronous, so the draw numbers are the CPU cost of issuing a frame, the draw calls
+// per frame are printed after them, and each asset's GPU memory and load time before them. A plain draw is a frame
+// where nothing changed, the retained scene is reused whole. Draws from the atlas when make atlas has built it
+// Usage: frame [--json file] [--filter text] [--seconds s]
+
+#include "Bench.h"
+#include "Game.h"
+#include "Graphics.h"
+#include "Input.h"
+#include "Resources.h"
+#include "Spritesheet.h"
+#include <SFML/Graphics.hpp>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+int main(int argc,char** argv){
+
+    Resources resources;
+    Spritesheet sheet(resources);
+    bool atlas=sheet.loadAtlas("assets/atlas.png","assets/atlas.bin"); // make atlas, measured as the game would run 
+    if (!atlas && (!sheet.loadFromFile("assets/Spritesheet.png") || !sheet.loadUndo("assets/Undo.png")
+        || !sheet.loadNewDeal("assets/NewDeal.png"))){
+        std::fprintf(stderr,"frame: can't load assets, run from the repository root\n");
+        return 1;
+    }
+    std::printf("%s\n",atlas ? "atlas: one texture" : "no atlas: separate textures, make atlas to build it");
+    resources.report(std::cout);
+    sf::RenderTexture target;
+    if (!target.resize({1024u,768u})){
+        std::fprintf(stderr,"frame: can't create an offscreen target\n");
+        return 1;
+    }
+
+    // A mid game position, the same every run 
+    Game game;
+    game.dealNewGame(7);
+    std::mt19937 rng(7);
+    Game::MoveBuffer moves;
+    for (int i=0;i<60;i++){
+        int count=game.generateMoves(moves);
+        if (count==0) break;
+        game.applyMove(moves[rng()%count]);
+    }
+
+    SolitaireGraphics graphics(sheet,game);
+    Input input(game,graphics,sheet);
+    bench::Harness harness("frame",argc,argv);
+
+    harness.run("SolitaireGraphics::draw",16,[](int){},[&](int){
+        target.clear(sf::Color(0,120,0));
+        graphics.draw(target,game);
+        target.display();
+    });
+
+    // A frame after every move, undo and redo alternating so the piles they touch are laid out again 
+    bool undone=false;
+    harness.run("SolitaireGraphics::draw after a move",1,[&](int){
+        if (undone) game.redo();
+        else game.undo();
+        undone=!undone;
+    },[&](int){
+        target.clear(sf::Color(0,120,0));
+        graphics.draw(target,game);
+        target.display();
+    });
+    if (undone) game.redo();
+    std::printf("piles laid out again after an undo or redo: %d\n",graphics.getPilesRebuilt());
+
+    // The same position mid drag of the longest face up Tableau run, with a hint showing 
+    int idleCalls=graphics.getDrawCalls();
+    for (int p=0;p<7;p++){
+        const std::vector<Card>& pile=game.getTableau(p);
+        for (std::size_t i=0;i<pile.size();i++){
+            if (!pile[i].getFaceUp()) continue;
+            if (!graphics.draggedCard || pile.size()-i>game.getTableau(graphics.draggedCard->getTableauPile()).size()-graphics.draggedCard->getTableauIndex()){
+                graphics.draggedCard=&pile[i];
+            }
+            break;
+        }
+    }
+    graphics.mouse={400.f,400.f};
+    graphics.hint=moves[0];
+    harness.run("SolitaireGraphics::draw drag",16,[](int){},[&](int){
+        target.clear(sf::Color(0,120,0));
+        graphics.draw(target,game);
+        target.display();
+    });
+    std::printf("draw calls per frame: %d still, %d dragging with a hint\n",idleCalls,graphics.getDrawCalls());
+    graphics.draggedCard=nullptr;
+    graphics.hint.reset();
+
+    // Button held over the Tableau, the per frame path that looks for the card to pick up 
+    const sf::Vector2f overTableau{graphics.stockpileXOffset+graphics.pileSpacing*3+10.f,graphics.tableauYOffset+5.f};
+    input.handleMouse(overTableau,true);
+    harness.run("Input::handleMouse held",64,[&](int){ graphics.draggedCard=nullptr; },[&](int){ input.handleMouse(overTableau,true); });
+
+    // Mouse up over empty table, the path of most frames 
+    const sf::Vector2f idle{900.f,700.f};
+    input.handleMouse(idle,false);
+    harness.run("Input::handleMouse idle",64,[](int){},[&](int){ input.handleMouse(idle,false); });
+
+    return harness.finish();
+}
@@ -0,0 +1,42 @@
+// movegen.cpp
+// Microbenchmark for Game::generateMoves, reports positions/sec and moves/sec
+
+#include "Game.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main(){
+
+    // Build a spread of positions by playing random legal moves from fresh deals 
+    std::mt19937 rng(12345);
+    std::vector<Game> positions;
+    Game::MoveBuffer moves;
+    while (positions.size()<1000){
+        Game game;
+        game.dealNewGame();
+        int steps=static_cast<int>(rng()%200);
+        for (int s=0;s<steps;s++){
+            int count=game.generateMoves(moves);
+            if (count==0) break;
+            game.applyMove(moves[rng()%count]);
+        }
+        positions.push_back(game);
+    }
+
+    const int rounds=2000;
+    long long generated=0;
+    auto start=std::chrono::steady_clock::now();
+    for (int r=0;r<rounds;r++){
+        for (const Game& game : positions) generated+=game.generateMoves(moves);
+    }
+    double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    double calls=static_cast<double>(rounds)*positions.size();
+    std::cout << "generateMoves: " << calls/seconds/1e6 << " M positions/sec, "
+              << generated/seconds/1e6 << " M moves/sec, "
+              << seconds*1e9/calls << " ns/call, "
+              << static_cast<double>(generated)/calls << " moves/position\n";
+    return 0;
+}
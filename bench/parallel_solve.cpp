@@ -0,0 +1,47 @@
+// parallel_solve.cpp
+// Speedup curve for ParallelSolver, solves a fixed set of deals at 1/2/4/8/16/32 threads
+// Usage: parallel_solve [deals] [nodes per deal]
+
+#include "Game.h"
+#include "ParallelSolver.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+int main(int argc,char** argv){
+
+    int deals=argc>1 ? std::atoi(argv[1]) : 16;
+    long long nodes=argc>2 ? std::atoll(argv[2]) : 2000000;
+
+    std::vector<Game> games;
+    for (int i=0;i<deals;i++){
+        games.emplace_back();
+        games.back().dealNewGame(static_cast<std::uint64_t>(i+1));
+    }
+
+    SolverConfig config;
+    config.maxNodes=nodes;
+    config.maxSeconds=0.0;
+    config.tableBytes=256u<<20;
+
+    double baseline=0.0;
+    std::cout << "threads  seconds  speedup  M nodes/sec  solved  unsolvable  out-of-budget\n";
+    for (int threads : {1,2,4,8,16,32}){
+        ParallelSolver solver(config,threads);
+        int counts[3]={0,0,0};
+        long long totalNodes=0;
+        auto start=std::chrono::steady_clock::now();
+        for (const Game& game : games){
+            SolveOutcome outcome=solver.solve(game);
+            counts[static_cast<int>(outcome.result)]++;
+            totalNodes+=outcome.stats.nodes;
+        }
+        double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+        if (threads==1) baseline=seconds;
+
+        std::cout << threads << "\t " << seconds << "\t  " << baseline/seconds << "\t   " << totalNodes/seconds/1e6
+                  << "\t\t" << counts[0] << "\t" << counts[1] << "\t    " << counts[2] << "\n";
+    }
+    return 0;
+}
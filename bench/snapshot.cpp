@@ -0,0 +1,63 @@
+// snapshot.cpp
+// Snapshot save and load times, for a fresh deal and for a game with a long undo history
+
+#include "Game.h"
+#include "Snapshot.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+namespace {
+
+// -- Times saving and loading game through path, printing microseconds per operation
+bool measure(const char* label,const Game& game,const std::string& path,int rounds){
+
+    auto start=std::chrono::steady_clock::now();
+    for (int i=0;i<rounds;i++){
+        if (!saveSnapshot(game,path)) return false;
+    }
+    double saveSeconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    Game loaded;
+    start=std::chrono::steady_clock::now();
+    for (int i=0;i<rounds;i++){
+        if (!loadSnapshot(loaded,path)) return false;
+    }
+    double loadSeconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    SnapshotView view;
+    start=std::chrono::steady_clock::now();
+    for (int i=0;i<rounds;i++){
+        if (!view.open(path) || !view.restore(loaded,false)) return false;
+    }
+    double viewSeconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    std::cout << label << ": " << game.getHistory().size() << " moves of history, save " << saveSeconds*1e6/rounds
+              << " us, load " << loadSeconds*1e6/rounds << " us, load without history " << viewSeconds*1e6/rounds << " us\n";
+    return loaded.getState()==game.getState();
+}
+
+}
+
+int main(){
+
+    const std::string path="bench-snapshot.tmp";
+
+    Game fresh;
+    fresh.dealNewGame(1);
+
+    Game played; // Random legal moves until the history is long, drawing and recycling keep it going once stuck 
+    played.dealNewGame(2);
+    std::mt19937 rng(2);
+    Game::MoveBuffer moves;
+    while (played.getHistory().size()<100000){
+        int count=played.generateMoves(moves);
+        if (count==0) break;
+        played.applyMove(moves[rng()%count]);
+    }
+
+    bool ok=measure("fresh deal",fresh,path,2000) && measure("long game ",played,path,200);
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
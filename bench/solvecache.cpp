@@ -0,0 +1,77 @@
+// solvecache.cpp
+// SolveCache benchmarks: lookups that hit and miss, and stores, on a table filled to a realistic load. Also reports
+// the hit rate left after filling a table past what its probe window holds, where the cheapest verdicts get evicted.
+// Usage: solvecache [--json file] [--filter text] [--seconds s]
+
+#include "Bench.h"
+#include "SolveCache.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+
+namespace {
+
+CachedSolve fakeVerdict(std::uint64_t deal){
+    CachedSolve entry;
+    entry.result=deal%10==0 ? SolveResult::Unsolvable : SolveResult::Solved;
+    entry.nodes=1000+deal%50000;
+    entry.micros=static_cast<std::uint32_t>(entry.nodes/4);
+    entry.solutionLength=static_cast<std::uint16_t>(entry.result==SolveResult::Solved ? 100+deal%80 : 0);
+    return entry;
+}
+
+}
+
+int main(int argc,char** argv){
+
+    bench::Harness harness("solvecache",argc,argv);
+    std::string path=(std::filesystem::temp_directory_path()/"solvecache-bench.kssc").string();
+    std::filesystem::remove(path);
+
+    const std::uint64_t slots=1u<<20;
+    const std::uint64_t filled=slots/2; // Half full
+    {
+        SolveCache cache;
+        if (!cache.open(path,slots)){
+            std::fprintf(stderr,"solvecache: can't create %s\n",path.c_str());
+            return 1;
+        }
+        for (std::uint64_t deal=1;deal<=filled;deal++) cache.store(deal,fakeVerdict(deal));
+
+        const int batch=256;
+        std::mt19937_64 rng(5);
+        std::uint64_t deals[batch];
+        CachedSolve entry;
+        long long found=0;
+        harness.run("lookup hit",batch,
+            [&](int i){ deals[i]=1+rng()%filled; },
+            [&](int i){ found+=cache.lookup(deals[i],entry); });
+        harness.run("lookup miss",batch,
+            [&](int i){ deals[i]=filled+1+rng()%filled; },
+            [&](int i){ found+=cache.lookup(deals[i],entry); });
+        std::uint64_t next=filled+1;
+        harness.run("store",batch,
+            [&](int i){ deals[i]=next++; },
+            [&](int i){ cache.store(deals[i],fakeVerdict(deals[i])); });
+        if (found<0) std::printf("unreachable\n"); // Keeps the lookups from being optimised away
+    }
+
+    // Twice as many deals as slots, then how many still answer
+    std::filesystem::remove(path);
+    {
+        const std::uint64_t small=1u<<16;
+        SolveCache cache;
+        cache.open(path,small);
+        for (std::uint64_t deal=1;deal<=2*small;deal++) cache.store(deal,fakeVerdict(deal));
+        CachedSolve entry;
+        std::uint64_t hits=0;
+        for (std::uint64_t deal=1;deal<=2*small;deal++) hits+=cache.lookup(deal,entry) ? 1 : 0;
+        std::printf("overfilled 2x: %.1f%% hit rate, %.1f%% of slots used, %zu byte file\n",100.0*hits/(2*small),
+            100.0*hits/small,cache.fileBytes());
+    }
+    std::filesystem::remove(path);
+    return harness.finish();
+
+}
@@ -0,0 +1,70 @@
+// variants.cpp
+// Rules engine benchmarks for each compiled rules variant ( see Rules.h ): random playouts, stock cycles and move
+// generation, to show a specialised engine costs nothing over plain Klondike
+// Usage: variants [--json file] [--filter text] [--seconds s]
+
+#include "Bench.h"
+#include "Game.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// -- The same three benchmarks for engine G, named after its variant
+template<class G>
+void variant(bench::Harness& harness,const std::string& name){
+
+    const int batch=64;
+    std::vector<G> games(batch);
+    typename G::MoveBuffer moves;
+    std::mt19937 rng(7);
+    std::uint64_t seed=1;
+
+    // 200 random legal moves from a fresh deal, the work a solver or playout does
+    harness.run(name+" playout x200",batch,
+        [&](int i){ games[i].dealNewGame(seed++); },
+        [&](int i){
+            for (int step=0;step<200;step++){
+                int count=games[i].generateMoves(moves);
+                if (count==0) break;
+                games[i].applyMove(moves[rng()%count]);
+            }
+        });
+
+    harness.run(name+" stock cycle",batch,
+        [&](int i){ games[i].dealNewGame(seed++); },
+        [&](int i){
+            while (!games[i].getReserve().empty()) games[i].dealFromReserve();
+            games[i].resetStockpile();
+        });
+
+    // Positions part way through a game, so every kind of move is around
+    std::vector<G> positions(256);
+    for (G& game : positions){
+        game.dealNewGame(seed++);
+        for (int step=0;step<40;step++){
+            int count=game.generateMoves(moves);
+            if (count==0) break;
+            game.applyMove(moves[rng()%count]);
+        }
+    }
+    std::size_t next=0;
+    harness.run(name+" generateMoves",batch,
+        [&](int i){ games[i]=positions[next++%positions.size()]; },
+        [&](int i){ games[i].generateMoves(moves); });
+
+}
+
+}
+
+int main(int argc,char** argv){
+
+    bench::Harness harness("variants",argc,argv);
+    variant<Game>(harness,"klondike");
+    variant<BasicGame<DrawThreeRules>>(harness,"draw three");
+    variant<BasicGame<VegasRules>>(harness,"vegas");
+    variant<BasicGame<RelaxedRules>>(harness,"relaxed");
+    return harness.finish();
+}
@@ -0,0 +1,86 @@
+// AnalysisWorker.h
+// Defines the AnalysisWorker, which runs the HintEngine on a background thread so the render loop never waits on it.
+// The loop hands over a snapshot of the position each time Game's revision changes, which cancels whatever was being
+// worked on. The worker refines its answer a batch of guesses at a time and publishes the best move so far in a single
+// atomic word, which the loop reads every frame without locking.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "Game.h"
+#include "GameState.h"
+#include "HintEngine.h"
+#include "Move.h"
+#include "TimingStats.h"
+
+struct AnalysisConfig{
+    HintConfig hint; // hint.samples is the total per position, hint.maxSeconds is ignored 
+    int batchSamples=8; // Guesses between publishing an improved answer, and so between cancellation checks 
+    int threads=0; // HintEngine workers, 0 for one per hardware thread 
+};
+
+class AnalysisWorker{
+
+public:
+
+    // The published answer, for the position at revision 
+    struct Suggestion{
+        bool valid=false; // Nothing published yet, or the position had no legal moves 
+        std::uint32_t revision=0; // Low 32 bits of Game::getRevision of the position analysed 
+        int moveIndex=0; // The move, as its index in Game::generateMoves for that position 
+        int winPercent=0; // Estimated chance of winning after it 
+        int samples=0; // Guesses the estimate is based on 
+    };
+
+    explicit AnalysisWorker(const AnalysisConfig& config=AnalysisConfig());
+    ~AnalysisWorker(); // Cancels any work and joins the thread 
+
+    AnalysisWorker(const AnalysisWorker&)=delete;
+    AnalysisWorker& operator=(const AnalysisWorker&)=delete;
+
+    // Hands over a new position, cancelling work on the previous one. Cheap, call it from the render loop 
+    // state -- Game::getState 
+    // revision -- Game::getRevision of that position 
+    void submit(const GameState& state,std::uint64_t revision);
+
+    void stop(); // Cancels the work in hand and drops any position waiting, i.e. once hints are hidden 
+
+    Suggestion suggestion() const; // The latest published answer, lock free 
+    bool busy() const { return working.load(std::memory_order_acquire); } // Whether the answer may still change, false once the last position is finished 
+
+    // Sets move to the suggested move if the suggestion is for game's current position, false otherwise 
+    bool suggestedMove(const Game& game,Move& move) const;
+
+    TimingStats latency() const; // Seconds from each submit to its first published answer 
+
+private:
+
+    AnalysisConfig config;
+    HintEngine engine;
+
+    std::mutex lock; // Guards the hand over below 
+    std::condition_variable wake;
+    GameState pending{};
+    std::uint64_t pendingRevision=0;
+    std::chrono::steady_clock::time_point submittedAt;
+    bool hasPending=false;
+    bool stopping=false;
+
+    std::atomic<bool> cancel{false}; // Set by submit, stops the engine between guesses 
+    std::atomic<std::uint64_t> published{0}; // Packed Suggestion, see pack 
+    std::atomic<bool> working{false}; // From submit until the worker runs out of positions 
+
+    mutable std::mutex statsLock;
+    TimingStats latencies;
+
+    std::thread thread; // Last, so everything it uses exists before it starts 
+
+    void run();
+    static std::uint64_t pack(const Suggestion& suggestion);
+    static Suggestion unpack(std::uint64_t word);
+
+};
@@ -0,0 +1,77 @@
+// Atlas.h
+// The texture atlas table: where each picture sits in the atlas image solitaire-atlas packs ( make atlas ), so the
+// front-end can draw the cards and the buttons from one texture. Also the shelf packer that lays the atlas out.
+// Neither needs SFML, the packer tool and Spritesheet deal with the pixels.
+//
+// File layout, little endian:
+//   AtlasHeader  32 bytes, magic "KSAT", version, entry size, entry count, atlas size
+//   entries      12 bytes each ( AtlasEntry ), sorted by key
+// Keys say what an entry is, see AtlasKey.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct AtlasHeader{
+    char magic[4];
+    std::uint16_t version;
+    std::uint16_t entryBytes;
+    std::uint32_t entryCount;
+    std::uint16_t width;
+    std::uint16_t height;
+    std::uint8_t padding[16];
+};
+static_assert(sizeof(AtlasHeader)==32, "AtlasHeader is a file format");
+
+struct AtlasEntry{
+    std::uint32_t key;
+    std::uint16_t x, y, width, height; // Pixels in the atlas image
+};
+static_assert(sizeof(AtlasEntry)==12, "AtlasEntry is a file format");
+
+namespace AtlasKey{
+    constexpr std::uint32_t frame(int frame) { return static_cast<std::uint32_t>(frame); } // Spritesheet frame numbers
+    constexpr std::uint32_t undo=0x100;
+    constexpr std::uint32_t newDeal=0x101;
+    constexpr std::uint32_t solid=0x102; // A white pixel, plain colour quads sample it so they need no other texture
+}
+
+class AtlasTable{
+
+public:
+
+    static constexpr char magicBytes[4]={'K','S','A','T'};
+    static constexpr std::uint16_t currentVersion=1;
+
+    bool load(const std::string& path); // False if it can't be read, isn't an atlas table or points outside the atlas
+    bool save(const std::string& path) const;
+
+    void add(const AtlasEntry& entry); // Replaces an entry with the same key, keeps them sorted
+    const AtlasEntry* find(std::uint32_t key) const; // nullptr if the atlas doesn't have it
+
+    // Getters and setters
+    void setSize(std::uint16_t w,std::uint16_t h) { width=w; height=h; }
+    std::uint16_t getWidth() const { return width; }
+    std::uint16_t getHeight() const { return height; }
+    const std::vector<AtlasEntry>& getEntries() const { return entries; }
+
+private:
+
+    std::uint16_t width=0;
+    std::uint16_t height=0;
+    std::vector<AtlasEntry> entries; // Sorted by key
+
+};
+
+// A rectangle to pack, width and height in, x and y out
+struct AtlasRect{
+    unsigned x=0, y=0;
+    unsigned width=0, height=0;
+};
+
+// -- Shelf packing: tallest first, left to right along a shelf as tall as its first rectangle, a new shelf below when
+// the next doesn't fit. padding pixels are left between neighbours so filtering never bleeds one into the next.
+// Returns the height used, 0 if a rectangle is wider than width
+unsigned packShelves(std::vector<AtlasRect>& rects,unsigned width,unsigned padding);
@@ -20,7 +20,8 @@ class Card{
 
 public:
 
-    // Constructor 
+    // Constructors
+    Card() : Card(Suit::Spades,Value::Ace,false,Location::Undecided,false) {}; // Placeholder card, i.e. for move buffers
     Card(Suit suit, Value value,bool faceUp,Location location, bool dragging)
     : suit(suit), value(value), faceUp(faceUp), location(location), dragging(dragging) {}; 
 
@@ -0,0 +1,27 @@
+// Delta.h
+// Packs one entry of the undo history, exactly what a move changed, into 16 bits
+//   bits 0-3   pile the cards came from ( GameState::Pile )
+//   bits 4-7   pile the cards went to 
+//   bits 8-12  how many cards moved 
+//   bit 13     the move turned the card left on top of the source pile face up 
+//   bit 14     the move is part of a group with the entry before it, undo and redo take the whole group at once 
+
+#pragma once
+#include <cstdint>
+
+struct Delta{
+
+    static constexpr std::uint16_t revealedBit=1u<<13;
+    static constexpr std::uint16_t groupBit=1u<<14;
+
+    static std::uint16_t encode(int from,int to,int count,bool revealed,bool grouped=false){
+        return static_cast<std::uint16_t>(from | (to<<4) | (count<<8) | (revealed ? revealedBit : 0) | (grouped ? groupBit : 0));
+    }
+
+    static int from(std::uint16_t delta) { return delta&0xF; }
+    static int to(std::uint16_t delta) { return (delta>>4)&0xF; }
+    static int count(std::uint16_t delta) { return (delta>>8)&0x1F; }
+    static bool revealed(std::uint16_t delta) { return (delta&revealedBit)!=0; }
+    static bool grouped(std::uint16_t delta) { return (delta&groupBit)!=0; }
+
+};
@@ -1,26 +1,50 @@
 //Game.h created by Andrew Gossen.
 // A core header for the game
 // Stores arrays for the Stockpile, Tableau, and Foundation Piles 
+// The engine is a template over a rules policy ( see Rules.h ), Game is plain draw one Klondike. Member functions are
+// defined in game.cpp and built there for each variant, add a variant to the list at its end to use it
 
 #pragma once
 #include "Card.h" // Access Card object 
 #include "Move.h" // Access Move object 
-#include "Game.h"
+#include "GameState.h" // Access compact GameState snapshots
+#include "Rules.h" // Variant policies 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include "Move.h"
 
 // Represents current state of the game and holds functions to make modifications to game
-class Game{
+template<class Rules>
+class BasicGame{
 
 public:
+
+    using RulesType=Rules;
+    // Upper bound on legal moves in any position. King only the worst case is 96. When any card may start an empty pile,
+    // each face up run ( 13 cards at most ) can go to every empty pile, up to 156 moves with 3 or 4 of them empty
+    static constexpr int maxMoves=Rules::emptyColumn==EmptyColumn::Any ? 256 : 128;
+    using MoveBuffer=std::array<Move,maxMoves>; // Caller provided storage for generateMoves
     
-    void dealNewGame(); // Will clear foundation piles and establish the stockpile and Tableau for a new game.
-    void applyMove(const Move& move,bool undo); // Will apply a move (assumed to be Valid) onto the private arrays in Game
+    void dealNewGame(); // Will clear foundation piles and establish the stockpile and Tableau for a new, random, game.
+    void dealNewGame(std::uint64_t seed); // As above, but deals game number seed, which is the same deal every time 
+    bool applyMove(const Move& move); // Will apply a move onto the private arrays in Game, returns false if it was illegal
     void undo(); // Undos the latest move 
+    void redo(); // Makes the latest undone move again, until a new move is made 
+    int autoComplete(); // Plays every foundation move that can't cost the game, grouped with the last move for undo, none while canRedo. Returns the cards moved 
     bool validMove(const Move& move) const; // Returns whether a move is legal for Solitaire Klondike. 
+    int generateMoves(MoveBuffer& moves) const; // Lists every legal move into moves without allocating, returns the count
+    bool canStackOnTableau(const Card& card,int pile) const; // Whether card may be placed on Tableau pile 
+    bool safeToFoundation(const Card& card) const; // Whether moving card up can never cost the game, see game.cpp 
+    bool canMoveToFoundation(const Card& card,int pile) const; // Whether card may be placed on foundation pile 
     void dealFromReserve(); // Will add a card from the reserve to the stockpile as the player wants to deal
     void resetStockpile(); // Will add a card from the reserve to the stockpile as the player wants to deal
+    bool canRecycle() const; // Whether the stockpile may go back to the reserve, now or once the reserve runs out 
+
+    // Compact snapshots
+    GameState getState() const; // Packs the current position, excluding move history, into a GameState
+    void setState(const GameState& state); // Replaces the current position with state and clears the move history
 
     //Getters
     const std::vector<Card>& getStockpile() const { return stockpile; }
@@ -28,24 +52,64 @@ public:
     const std::vector<Card>& getTableau(int i) const { return tableau[i]; }
     const std::vector<Card>& getFoundation(int i) const { return foundations[i]; }
     bool getWon() const { return won; }
+    std::uint64_t getDealSeed() const { return dealSeed; } // Deal number of the current game 
+    bool canUndo() const { return historyCursor>0; }
+    bool canRedo() const { return historyCursor<history.size(); }
+    std::uint64_t getRevision() const { return revision; } // Goes up every time the position changes 
+    std::uint32_t getPileRevision(int id) const { return pileRevisions[id]; } // Goes up every time pile id ( GameState::Pile ) changes, so a view can redo only those 
+    std::uint64_t getHash() const { return hash; } // Zobrist hash of the position, kept up to date move by move. Recycles used aren't part of it 
+    int getScore() const { return score; } // Under Rules::scoring, follows undo and redo 
+    int getRecycles() const { return recycles; } // Times the stockpile has gone back to the reserve this game, only counted when Rules::recycleLimit limits it 
+    std::uint64_t computeHash() const; // The same hash, recomputed from every pile 
+    const std::vector<std::uint16_t>& getHistory() const { return history; } // Delta per move, see Delta.h 
+    std::size_t getHistoryCursor() const { return historyCursor; } // Moves in getHistory before this are applied 
 
     //Setters
     void setWon(bool hasWon) {won=hasWon;}
+    void setDealSeed(std::uint64_t seed) {dealSeed=seed;}
+    bool setHistory(const std::uint16_t* entries,std::size_t count,std::size_t cursor); // Replaces the undo history, returns false if it doesn't fit the position 
 
 private:
 
     bool won=false; // Whether the game has been won 
+    std::uint64_t dealSeed=0; // Deal number passed to dealNewGame 
+    std::uint64_t hash=0; // Zobrist hash of the position ( see Zobrist.h ) 
+    std::uint64_t revision=0; // Count of changes, so observers can tell the position moved on without comparing it 
+    std::array<std::uint32_t,GameState::PileCount> pileRevisions{}; // The same, per pile 
+    int score=0;
+    int recycles=0;
 
-    void FoundationLogic(const Move& move, const Card& movingCard,std::vector<Card> &cardArray,bool undo);
-    void TableauToTableauLogic(const Move& move, const Card& movingCard,bool undo);
-    void pushToTableau(const Move& move, Card movingCard,std::vector<Card> &popBackArray);
-    void pushToStockpile(Card movingCard,std::vector<Card> &popBackArray);
-    void logMove(Card c,Move move);
+    std::vector<Card>& pile(int id); // Pile for a GameState::Pile id 
+    void transfer(int from,int to,int count); // Moves cards between piles, no rules, no history 
+    void play(int from,int to,int count,bool grouped=false); // Makes a checked move and logs it 
+    void undoOne();
+    void redoOne();
+    void account(std::uint16_t delta,int sign); // Adds ( sign 1 ) or takes back ( -1 ) a history entry's score and recycle 
+    static int scoreOf(std::uint16_t delta);
+    static constexpr int startingScore() { return Rules::scoring==Scoring::Vegas ? -52 : 0; }
+    static int cardIndex(const Card& c) { return Compatibility::cardIndex(static_cast<int>(c.getSuit()),static_cast<int>(c.getValue())); }
+    void updateWon();
+    void turnTop(int id,bool faceUp); // Flips the top card of a pile, keeping the hash up to date 
+    static std::uint64_t cardKey(const Card& c,int pileId,int index);
+    void checkHash(const char* where) const; // Only checks when built with SOLITAIRE_CHECK_HASH 
 
     std::vector<Card> reserve; // Holds all cards not yet dealt
     std::vector<Card> stockpile; // Holds all cards currently dealt
-    std::vector<Move> moveHistory; // Holds history of moves for the undo function 
+    std::vector<std::uint16_t> history; // Delta per move ( see Delta.h ) for undo and redo 
+    std::size_t historyCursor=0; // Entries before this are applied, the rest have been undone 
+
+    // Auto complete bookkeeping, bit n stands for GameState::Pile n 
+    std::uint16_t dirtyPiles=0xFFFF; // Piles whose top card changed since autoComplete last looked at it 
+    std::array<std::uint16_t,4> waitingOn{}; // Per suit, piles whose top can't go up until that suit's foundation grows 
     std::array<std::vector<Card>, 7> tableau;  // Holds each seven Tabelau piles and their respective cards.
     std::array<std::vector<Card>, 4> foundations; // Holds each four foundation piles and their respective cards.
 
-};
\ No newline at end of file
+};
+
+using Game=BasicGame<KlondikeRules>;
+
+// Built in game.cpp 
+extern template class BasicGame<KlondikeRules>;
+extern template class BasicGame<DrawThreeRules>;
+extern template class BasicGame<VegasRules>;
+extern template class BasicGame<RelaxedRules>;
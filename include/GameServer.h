@@ -0,0 +1,82 @@
+// GameServer.h
+// Hosts many games in one process for clients on a local socket, speaking the binary protocol of Protocol.h.
+// One thread serves every connection through poll, sessions come from a SessionPool and any connection may drive
+// any session. Addresses are "host:port" ( or ":port" for every interface ) for TCP, anything else is a Unix socket
+// path. POSIX only, on Windows listen and connect fail
+
+#pragma once
+#include "Protocol.h"
+#include "SessionPool.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class GameServer{
+
+public:
+
+    explicit GameServer(std::uint32_t maxSessions=SessionPool::maxSlots);
+    ~GameServer();
+    GameServer(const GameServer&)=delete;
+    GameServer& operator=(const GameServer&)=delete;
+
+    bool listen(const std::string& address); // Starts listening, false with error() set if it can't
+    void run(); // Serves connections until stop is called
+    void stop() { stopping.store(true); } // Safe from any thread or a signal handler, run returns within 100 ms
+
+    // Serves one request, appending its Response and payload to out. The socket loop calls this for each request,
+    // it's public so the protocol can be driven without a socket
+    void handle(const Request& request,std::vector<unsigned char>& out);
+
+    // Getters
+    const std::string& error() const { return lastError; }
+    const SessionPool& getPool() const { return pool; }
+
+private:
+
+    struct Connection{
+        int socket;
+        std::vector<unsigned char> in; // Start of a request not yet complete
+        std::vector<unsigned char> out; // Responses not yet sent
+        std::size_t sent=0; // Of out
+    };
+
+    bool serve(Connection& connection); // Reads and answers what the connection has sent, false once it's closed
+    bool flush(Connection& connection); // Sends what it can of out, false on a socket error
+    ServerStats stats() const;
+
+    SessionPool pool;
+    std::vector<Connection> connections;
+    std::vector<unsigned char> readBuffer; // Shared by every connection, the loop serves one at a time
+    std::atomic<bool> stopping{false};
+    int listener=-1;
+    std::string unixPath; // Removed again on shutdown
+    std::uint64_t requests=0;
+    std::string lastError;
+
+};
+
+// Blocking client end of the protocol, one request in flight or a pipeline of them
+class GameClient{
+
+public:
+
+    GameClient() = default;
+    ~GameClient();
+    GameClient(const GameClient&)=delete;
+    GameClient& operator=(const GameClient&)=delete;
+
+    bool connect(const std::string& address); // address -- As for GameServer::listen
+    bool send(const Request* requests,std::size_t count); // Sends count requests without waiting for answers
+    bool receive(Response& response,void* payload=nullptr,std::size_t payloadSize=0); // Next response, payload beyond payloadSize is dropped
+    bool call(const Request& request,Response& response,void* payload=nullptr,std::size_t payloadSize=0); // send then receive
+
+private:
+
+    bool readFully(void* data,std::size_t size);
+
+    int socket=-1;
+
+};
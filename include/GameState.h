@@ -0,0 +1,74 @@
+// GameState.h
+// Defines GameState, a compact, trivially copyable snapshot of a game position
+// Every card is packed into one byte and all piles live back to back in a single 52 byte array,
+// so a position can be copied, compared or hashed as plain memory
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "Card.h"
+
+struct GameState{
+
+    // Pile order within the card array 
+    enum Pile : std::uint8_t{
+        Reserve=0,
+        Stockpile=1,
+        Tableau0=2, // Tableau piles are Tableau0 .. Tableau0+6
+        Foundation0=9, // Foundation piles are Foundation0 .. Foundation0+3
+        PileCount=13
+    };
+
+    // Card byte layout, bits 0-3 value, bits 4-5 suit, bit 6 face up
+    static constexpr std::uint8_t valueMask=0x0F;
+    static constexpr std::uint8_t suitShift=4;
+    static constexpr std::uint8_t faceUpBit=0x40;
+
+    std::uint8_t cards[52]; // Each pile bottom to top, piles in Pile order 
+    std::uint8_t pileEnd[PileCount]; // One past the last card of each pile, a pile starts where the previous one ends 
+    std::uint8_t won; // Whether the game has been won 
+
+    // Pile access
+    int pileStart(int pile) const { return pile==0 ? 0 : pileEnd[pile-1]; }
+    int pileSize(int pile) const { return pileEnd[pile]-pileStart(pile); }
+    const std::uint8_t* pileBegin(int pile) const { return cards+pileStart(pile); }
+
+    // Card packing
+    static std::uint8_t packCard(const Card& card){
+        return static_cast<std::uint8_t>(static_cast<int>(card.getValue()) | (static_cast<int>(card.getSuit())<<suitShift) | (card.getFaceUp() ? faceUpBit : 0));
+    }
+    static Card unpackCard(std::uint8_t packed, Location location){
+        return Card(static_cast<Suit>((packed>>suitShift)&3), static_cast<Value>(packed&valueMask), (packed&faceUpBit)!=0, location, false);
+    }
+
+    // 64 bit hash of the whole position, mixes the bytes eight at a time 
+    std::uint64_t hash() const{
+        std::uint64_t words[9]={};
+        std::memcpy(words,this,sizeof(GameState));
+        std::uint64_t h=0x9E3779B97F4A7C15ull;
+        for (std::uint64_t w : words){
+            h^=w;
+            h*=0xBF58476D1CE4E5B9ull;
+            h^=h>>31;
+        }
+        return h;
+    }
+
+    // Deal number dealNumber, identical on every machine:
+    //  1. The deck starts in suit order Spades, Hearts, Clubs, Diamonds, each Ace to King
+    //  2. Xoshiro256 seeded with dealNumber shuffles it, for i from 51 down to 1 swap card i with card below(i+1)
+    //  3. Cards are dealt from the end of the deck, Tableau pile 0 gets 1 card, pile 1 gets 2 and so on, the last card
+    //     of each pile face up. The 24 cards left form the reserve, its last card is the first one dealt
+    static GameState dealt(std::uint64_t dealNumber);
+
+    // Whether this is a real position, every card exactly once and pile ends in order, i.e. after reading one from a file 
+    bool valid() const;
+
+    bool operator==(const GameState& other) const { return std::memcmp(this,&other,sizeof(GameState))==0; }
+    bool operator!=(const GameState& other) const { return !(*this==other); }
+
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must be copyable with memcpy");
+static_assert(sizeof(GameState)==66, "GameState should have no padding so it can be compared and hashed bytewise");
@@ -1,21 +1,33 @@
 // Graphics.h, created by Andrew Gossen.
 // Defines the SolitaireGraphics class, which holds all essentials required for rendering the game 
+// The scene is retained: each pile's cards are kept as a QuadBatch, rebuilt only when Game::getPileRevision says the pile
+// changed ( or the drag or the back animation moved on ), and the piles are joined into one batch drawn in a single
+// call. Only the dragged run and the hint outlines are built every frame, so a frame where nothing changed does no
+// per card work and allocates nothing. With the Spritesheet's atlas loaded everything shares one texture, so the scene
+// and empty slots are joined once per change and the frame is two draw calls: that, then what moves over it
 
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <optional>
 #include "Game.h"
 #include "Move.h"
 #include "Card.h"
+#include "QuadBatch.h"
 #include "Spritesheet.h"
 
 class SolitaireGraphics {
 
 public:
 
-    SolitaireGraphics(Spritesheet& sheet, sf::Font& font,Game& gameInstance)
-    : sheet(sheet), font(font), game(gameInstance) {};
+    SolitaireGraphics(Spritesheet& sheet,Game& gameInstance)
+    : sheet(sheet), game(gameInstance) {};
 
-    void draw(sf::RenderWindow& window, const Game& game, bool showWinText) const; // Renders the entire game 
+    void draw(sf::RenderTarget& window, const Game& game) const; // Renders the entire game, to the window or an offscreen target 
+    int getDrawCalls() const { return drawCalls; } // Draw calls the last frame took 
+    int getPilesRebuilt() const { return pilesRebuilt; } // Piles whose cards the last frame had to lay out again 
+    void invalidate() { sceneBuilt=false; } // Rebuild every pile next frame, i.e. after replacing the Game wholesale 
     
     // UI Config
     const float pileSpacing       = 120.f; // Card spacing between Tableau piles and foundation piles 
@@ -33,21 +45,40 @@ public:
     const float newDealYOffset=600.0f; // How many pixels down the new deal button is 
 
     const Card* draggedCard=nullptr; // Points to any card being dragged 
+    sf::Vector2f mouse; // Mouse position from the latest Input::getHovered, dragged cards follow it 
+    std::optional<Move> hint; // Move to highlight, if any 
 
 private:
 
     Spritesheet& sheet;
-    sf::Font& font;
     Game& game; 
 
-    sf::Texture undo;
+    // Retained scene, kept between frames 
+    mutable std::array<QuadBatch,GameState::PileCount> pileCards; // Per GameState::Pile, that pile's cards 
+    mutable std::array<std::uint32_t,GameState::PileCount> builtRevisions{}; // Game::getPileRevision each was built at 
+    mutable QuadBatch scene; // Every pile joined, in back to front order 
+    mutable QuadBatch slots; // Outlines of empty foundations, under the cards 
+    mutable QuadBatch joined; // Slots and scene together, kept with the scene when the atlas lets them share a draw 
+    mutable bool sceneBuilt=false;
+    mutable const Card* builtDragged=nullptr; // draggedCard the scene left out 
+    mutable int builtBackFrame=-1; // Spritesheet::backFrame face down cards show 
 
-    void drawDealtCard(sf::RenderWindow&, const Game&) const;
-    void drawFoundations(sf::RenderWindow&, const Game&) const;
-    void drawTableau(sf::RenderWindow&) const;
-    void drawStockpile(sf::RenderWindow&, const Game&) const;
-    void drawDragging(sf::RenderWindow&) const;
-    void drawUndo(sf::RenderWindow&) const;
-    void drawNewDeal(sf::RenderWindow&) const;
+    // Rebuilt every frame, their memory is reused 
+    mutable QuadBatch dragged; // The dragged card and any run on it 
+    mutable QuadBatch overlay; // Hint outlines, over the cards 
+    mutable int drawCalls=0;
+    mutable int pilesRebuilt=0;
+
+    void addCard(QuadBatch& batch, int frame, sf::Vector2f position) const; // Queues a Spritesheet frame at position 
+    void updateScene(const Game&) const;
+    void drawFoundation(int i, const Game&) const;
+    void drawTableau(int i) const;
+    void drawReserve(const Game&) const;
+    void drawStockpile(const Game&) const;
+    void drawDragging() const;
+    void drawUndo(sf::RenderTarget&) const;
+    void drawNewDeal(sf::RenderTarget&) const;
+    void addButtons(QuadBatch& batch) const;
+    void drawHint() const;
 
 };
@@ -0,0 +1,67 @@
+// HintEngine.h
+// Defines the HintEngine, which suggests a move using only what the player can see. The face down Tableau cards and
+// the reserve order are unknown, so it deals many guesses of them ( determinizations ), runs a shallow Solver search
+// after each legal move in each guess, and ranks the moves by how often a win was found. Guesses run in parallel.
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Game.h"
+#include "GameState.h"
+#include "Move.h"
+#include "Solver.h"
+#include "ThreadPool.h"
+
+struct HintConfig{
+    int samples=64; // Guesses of the hidden cards to try 
+    double maxSeconds=1.0; // Deadline, no new guesses are started after it, 0 for none 
+    long long nodesPerSolve=5000; // Solver budget for each move in each guess, more is slower but finds more wins 
+    std::uint64_t seed=1; // The same seed and position give the same guesses 
+};
+
+struct MoveHint{
+    Move move;
+    int index=0; // Where the move is in Game::generateMoves order 
+    int wins=0; // Guesses where a win was found after this move 
+    int losses=0; // Guesses where the search proved there is no win after it 
+    int samples=0; // Guesses tried 
+    double winRate() const { return samples ? static_cast<double>(wins)/samples : 0.0; } // Estimated chance of winning, searches that ran out of budget count as losses 
+};
+
+struct HintReport{
+    std::vector<MoveHint> moves; // Every legal move, best first 
+    int samples=0; // Guesses completed before the deadline 
+    double seconds=0.0;
+    bool deadlineHit=false; // Fewer guesses than asked for were made 
+    bool cancelled=false; // Stopped early by the cancel flag 
+    double samplesPerSecond() const { return seconds>0.0 ? samples/seconds : 0.0; }
+};
+
+class HintEngine{
+
+public:
+
+    // config -- Sample count, deadline and search budget 
+    // threads -- Worker count, 0 for one per hardware thread 
+    explicit HintEngine(const HintConfig& config=HintConfig(),int threads=0);
+
+    // Ranks game's legal moves, game itself is left untouched 
+    // cancel -- If given, no new guesses are started once it is set 
+    // firstSample -- Number of the first guess, so repeated calls with different values make different guesses 
+    HintReport hint(const Game& game,const std::atomic<bool>* cancel=nullptr,std::uint64_t firstSample=0);
+
+    // A copy of state with the face down Tableau cards and the reserve shuffled among themselves, everything the player
+    // can see stays where it is 
+    static GameState determinize(const GameState& state,std::uint64_t seed);
+
+    int threads() const { return pool.size(); }
+
+private:
+
+    HintConfig config;
+    ThreadPool pool;
+    std::vector<std::unique_ptr<Solver>> solvers; // One per pool worker 
+
+};
@@ -5,6 +5,7 @@
 #include "Card.h"
 #include "Spritesheet.h"
 #include "Graphics.h"
+#include "Recording.h"
 #include <SFML/Graphics.hpp>
 #pragma once 
 
@@ -17,6 +18,9 @@ public:
     : game(gameInstance), graphics(graphics), sheet(sheet) {};
 
     void getHovered(sf::RenderWindow& window); // Sets the hovered card data
+    void handleMouse(sf::Vector2f mouse,bool mouseDown); // As getHovered, for a given mouse state, i.e. without a window 
+    void setRecorder(SessionRecorder* sessionRecorder) { recorder=sessionRecorder; } // Records every action taken, nullptr to stop 
+    void autoComplete(); // Runs Game::autoComplete, recording it if anything moved. After every change but an undo, and once on a fresh deal 
 
 private:
 
@@ -26,5 +30,8 @@ private:
     Game& game;
     SolitaireGraphics& graphics;
     Spritesheet& sheet;
+    SessionRecorder* recorder=nullptr;
+
+    void play(const Move& move); // Applies a move, recording it if it was legal 
 
 };
\ No newline at end of file
@@ -0,0 +1,36 @@
+// MappedFile.h
+// Read only memory map of a whole file, so a file's contents can be used in place without being read or parsed.
+// Pages are only loaded from disk when first touched. POSIX mmap, or a file mapping on Windows
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+class MappedFile{
+
+public:
+
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path); // Maps path, returns false if it can't be opened or is empty 
+    void close();
+
+    const unsigned char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+    bool isOpen() const { return bytes!=nullptr; }
+
+private:
+
+    const unsigned char* bytes=nullptr;
+    std::size_t length=0;
+#ifdef _WIN32
+    void* fileHandle=nullptr;
+    void* mappingHandle=nullptr;
+#endif
+
+};
@@ -9,6 +9,7 @@ class Move{
 
 public:
 
+    Move() : Move(Card(),Location::Undecided,Location::Undecided,-1,-1) {}; // Placeholder move, i.e. for move buffers
     Move(Card card,Location startingPosition,Location destination,int pile,int startingPile)
     : card(card), startingPosition(startingPosition), destination(destination), pile(pile),
     startingPile(startingPile) {};
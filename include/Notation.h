@@ -0,0 +1,29 @@
+// Notation.h
+// Short text notation for cards and moves, used by the headless tools to read and write move scripts
+//
+//   draw, recycle      -- Deal a card from the reserve / return the stockpile to the reserve
+//   w>t3, w>f0         -- Move the top stockpile ( 'waste' ) card to a Tableau or foundation pile
+//   t2>f1, t2:4>t5     -- Move from Tableau pile 2, optionally starting at card index 4 ( i.e. a run of cards )
+//   f0>t3              -- Move the top card of foundation pile 0 back onto Tableau pile 3
+
+#pragma once
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "Card.h"
+#include "Game.h"
+#include "Move.h"
+
+std::string formatCard(const Card& card); // i.e. "QH", or "##" if the card is face down
+std::string formatMove(const Move& move); // i.e. "t2:4>t5"
+
+// Builds a move from its notation against the current position, returns false if the text can't be parsed
+// or refers to a card that doesn't exist. Legality is not checked here.
+bool parseMove(const Game& game, std::string_view text, Move& move);
+
+// Moves as GameState::Pile ids, the compact form recordings and the server protocol use. index is the Tableau index
+// of the first card moved, 0 for any other pile
+void movePiles(const Move& move, int& from, int& to, int& index);
+bool pileMove(const Game& game, int from, int to, int index, Move& move); // Rebuilds one, false if the card isn't there
+
+void printGame(std::ostream& out, const Game& game); // Prints every pile, one per line
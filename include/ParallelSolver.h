@@ -0,0 +1,56 @@
+// ParallelSolver.h
+// Defines the ParallelSolver, which spreads one Solver search over a work stealing ThreadPool
+// Every worker runs an ordinary Solver on a piece of the tree, and whenever a worker goes idle the busy ones
+// hand it the untried steps of the node they are on. All of them share one ConcurrentTranspositionTable.
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Game.h"
+#include "GameState.h"
+#include "Solver.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+
+class ParallelSolver{
+
+public:
+
+    // config -- Budgets as for Solver, findShortest is ignored, the first solution found is returned 
+    // threads -- Worker count, 0 for one per hardware thread 
+    explicit ParallelSolver(const SolverConfig& config=SolverConfig(),int threads=0);
+
+    SolveOutcome solve(const Game& game); // Searches from game's position, game itself is left untouched 
+
+    int threads() const { return pool.size(); }
+
+private:
+
+    friend class Solver; // Workers report nodes, solutions and split requests back 
+
+    static constexpr int maxSplitDepth=64; // Steps below this deep are left to the worker that found them 
+
+    SolverConfig config;
+    ThreadPool pool;
+    ConcurrentTranspositionTable table;
+    std::vector<std::unique_ptr<Solver>> workers; // One per pool worker 
+
+    // Shared search state
+    std::atomic<bool> stop{false};
+    std::atomic<bool> truncated{false};
+    std::atomic<long long> nodes{0};
+    double startTime=0.0;
+    std::mutex solutionLock;
+    std::vector<Move> solution;
+    bool solved=false;
+
+    bool stopRequested() const { return stop.load(std::memory_order_relaxed); }
+    void chargeNodes(long long count); // Adds a worker's nodes to the total, stopping the search if the budget is spent 
+    bool wantsWork(int depth) const; // Whether a worker at depth should split off its remaining steps 
+    void report(const std::vector<Move>& path); // A worker found a win 
+    void split(Solver& from,std::size_t firstStep,std::size_t endStep,int depth); // Queues from's steps [first,end) as tasks 
+    void runTask(const GameState& state,const std::vector<Move>& path,int depth); // Searches below state on the calling worker 
+
+};
@@ -0,0 +1,65 @@
+// Protocol.h
+// Binary protocol of solitaire-server ( see GameServer.h ). A client sends fixed 16 byte Requests and gets back one
+// Response per Request, in order, each followed by payloadBytes of payload:
+//   Open     -- seed is the deal number, returns the new session. Status Full when every session is taken
+//   Close    -- Ends session, its game goes back to the pool
+//   Deal     -- Deals game number seed in session
+//   Move     -- from / to are GameState::Pile ids and index the Tableau index of the first card moved, as in
+//               Recording.h. Reserve to Stockpile draws, Stockpile to Reserve recycles
+//   Undo, Redo
+//   State    -- Payload is the session's GameState
+//   Stats    -- Payload is a ServerStats, session is ignored
+// Every response but Stats carries Game::getHash of the session's position after the request, so a client can check
+// it is in step. Every field is little endian, as on every platform the game is built for.
+
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+enum class Op : std::uint8_t{
+    Open=1,
+    Close=2,
+    Deal=3,
+    Move=4,
+    Undo=5,
+    Redo=6,
+    State=7,
+    Stats=8
+};
+
+enum class Status : std::uint8_t{
+    Ok=0,
+    Illegal=1, // The move isn't legal in the session's position, nothing changed
+    NoSession=2, // The session doesn't exist or has been closed
+    Full=3, // No session left to open
+    BadRequest=4 // Unknown op or malformed fields
+};
+
+struct Request{
+    Op op;
+    std::uint8_t from=0;
+    std::uint8_t to=0;
+    std::uint8_t index=0;
+    std::uint32_t session=0;
+    std::uint64_t seed=0;
+};
+
+struct Response{
+    Status status;
+    Op op;
+    std::uint16_t payloadBytes=0;
+    std::uint32_t session=0;
+    std::uint64_t hash=0;
+};
+
+struct ServerStats{
+    std::uint32_t sessions; // Open right now
+    std::uint32_t slots; // Games the pool holds, open or free
+    std::uint64_t poolBytes; // Memory the pool holds, card storage included
+    std::uint64_t requests; // Served since the server started
+    std::uint32_t connections;
+    std::uint32_t padding;
+};
+
+static_assert(sizeof(Request)==16 && sizeof(Response)==16, "Protocol messages are fixed size");
+static_assert(std::is_trivially_copyable<Request>::value && std::is_trivially_copyable<Response>::value, "Protocol messages are sent as plain memory");
@@ -0,0 +1,32 @@
+// QuadBatch.h
+// Collects rectangles into one sf::VertexArray of triangles so a whole layer of the frame, i.e. every card, goes to
+// the GPU in a single draw call instead of one per sprite. Clearing keeps the array's memory, so refilling it every
+// frame doesn't allocate once it has grown to the biggest frame seen
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+class QuadBatch{
+
+public:
+
+    QuadBatch() : vertices(sf::PrimitiveType::Triangles) {}
+
+    void clear() { vertices.clear(); }
+    void add(sf::FloatRect where,const sf::IntRect& textureRect); // A textured rectangle, i.e. a card sprite 
+    // A plain colour border drawn outside where, as sf::RectangleShape's outline. Drawn with a texture it samples solidTexel,
+    // which should be white, i.e. Spritesheet::solidTexel, so it can share a batch with the cards 
+    void addOutline(sf::FloatRect where,float thickness,sf::Color color,sf::Vector2f solidTexel={});
+    void append(const QuadBatch& other); // Adds every rectangle of other after these 
+    int draw(sf::RenderTarget& target,const sf::Texture* texture) const; // Draws everything added, returns the draw calls made, 0 or 1 
+
+    std::size_t quads() const { return vertices.getVertexCount()/6; }
+
+private:
+
+    sf::VertexArray vertices; // Six vertices, two triangles, per rectangle 
+
+    void addQuad(sf::FloatRect where,sf::FloatRect texture,sf::Color color);
+
+};
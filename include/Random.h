@@ -0,0 +1,77 @@
+// Random.h
+// Small, fast, seedable random number generators, so runs can be reproduced on any machine and each thread can keep
+// its own generator in a few bytes ( std::mt19937 keeps 5 KB of state )
+
+#pragma once
+#include <cstdint>
+#include <limits>
+
+// SplitMix64, used to spread a seed over the state of Xoshiro256
+class SplitMix64{
+
+public:
+
+    explicit SplitMix64(std::uint64_t seed) : state(seed) {};
+
+    std::uint64_t next(){
+        std::uint64_t z=(state+=0x9E3779B97F4A7C15ull);
+        z=(z^(z>>30))*0xBF58476D1CE4E5B9ull;
+        z=(z^(z>>27))*0x94D049BB133111EBull;
+        return z^(z>>31);
+    }
+
+private:
+
+    std::uint64_t state;
+
+};
+
+// xoshiro256** by Blackman and Vigna, 32 bytes of state. Also a standard UniformRandomBitGenerator
+class Xoshiro256{
+
+public:
+
+    using result_type=std::uint64_t;
+
+    explicit Xoshiro256(std::uint64_t seed){
+        SplitMix64 seeder(seed);
+        for (std::uint64_t& word : s) word=seeder.next();
+    }
+
+    std::uint64_t next(){
+        std::uint64_t result=rotl(s[1]*5,7)*9;
+        std::uint64_t t=s[1]<<17;
+        s[2]^=s[0];
+        s[3]^=s[1];
+        s[1]^=s[2];
+        s[0]^=s[3];
+        s[2]^=t;
+        s[3]=rotl(s[3],45);
+        return result;
+    }
+
+    // Uniform integer in [0,bound), without the bias of next()%bound ( Lemire's multiply and reject )
+    std::uint32_t below(std::uint32_t bound){
+        std::uint64_t m=(next()>>32)*bound;
+        std::uint32_t low=static_cast<std::uint32_t>(m);
+        if (low<bound){
+            std::uint32_t threshold=static_cast<std::uint32_t>(-bound)%bound;
+            while (low<threshold){
+                m=(next()>>32)*bound;
+                low=static_cast<std::uint32_t>(m);
+            }
+        }
+        return static_cast<std::uint32_t>(m>>32);
+    }
+
+    result_type operator()() { return next(); }
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+private:
+
+    std::uint64_t s[4];
+
+    static std::uint64_t rotl(std::uint64_t x,int k) { return (x<<k)|(x>>(64-k)); }
+
+};
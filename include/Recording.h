@@ -0,0 +1,91 @@
+// Recording.h
+// Session recording and replay. A recording is the deal number of every game plus each action taken, with the time it
+// was taken, so a session can be played back exactly, i.e. to reproduce a bug or as a load test. The file is
+//
+//   "KSRC" magic, std::uint16_t version, std::uint16_t reserved 
+//   RecordedEvent, repeated, Deal and End events are followed by a std::uint64_t ( the deal number / final hash )
+//
+// Every field is little endian. A recording is only complete once finish has written its End event 
+
+#pragma once
+#include "Game.h"
+#include "Move.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+enum class RecordedAction : std::uint8_t{
+    Deal=1, // dealNewGame, followed by the deal number 
+    Move=2, // applyMove, from / to are GameState::Pile ids and index the Tableau index of the moved card 
+    Draw=3, // dealFromReserve 
+    Recycle=4, // resetStockpile 
+    Undo=5,
+    Redo=6,
+    End=7, // Session over, followed by Game::getHash of the final position 
+    AutoComplete=8 // Game::autoComplete, only recorded when it moved something 
+};
+
+struct RecordedEvent{
+    std::uint32_t millis; // Milliseconds since recording started 
+    RecordedAction action;
+    std::uint8_t from;
+    std::uint8_t to;
+    std::uint8_t index;
+};
+
+static_assert(sizeof(RecordedEvent)==8, "RecordedEvent is a file format");
+static_assert(std::is_trivially_copyable<RecordedEvent>::value, "RecordedEvent is written as raw bytes");
+
+// Appends a session's actions to a recording file. Only record actions the Game actually took, i.e. moves applyMove
+// accepted, the replay checks each one is legal again 
+class SessionRecorder{
+
+public:
+
+    static constexpr char magicBytes[4]={'K','S','R','C'};
+    static constexpr std::uint16_t currentVersion=1;
+
+    SessionRecorder() = default;
+    ~SessionRecorder(); // Closes without an End event if finish wasn't called, the replay reports it as incomplete 
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    bool open(const std::string& path); // Starts a new recording at path, returns false if it can't be created 
+    bool isOpen() const { return out!=nullptr; }
+
+    void deal(std::uint64_t seed);
+    void move(const Move& move);
+    void draw() { write(RecordedAction::Draw); }
+    void recycle() { write(RecordedAction::Recycle); }
+    void undo() { write(RecordedAction::Undo); }
+    void redo() { write(RecordedAction::Redo); }
+    void autoComplete() { write(RecordedAction::AutoComplete); }
+    bool finish(const Game& game); // Writes the End event for game's final position and closes, false on a write error 
+
+private:
+
+    void write(RecordedAction action,int from=0,int to=0,int index=0);
+
+    std::FILE* out=nullptr;
+    std::chrono::steady_clock::time_point start;
+
+};
+
+struct ReplayResult{
+    bool ok=false; // Every event replayed, and the final position matched 
+    bool complete=false; // The recording ended with an End event 
+    std::size_t events=0; // Events replayed 
+    std::size_t moves=0; // Of which moves 
+    std::uint32_t millis=0; // Time stamp of the last event, how long the session lasted 
+    std::string error; // Why not ok, with the event number 
+};
+
+// Replays a recording held in memory into game, as fast as the engine goes. Stops at the first event that can't be
+// replayed, i.e. a move that is now illegal 
+ReplayResult replayRecording(const unsigned char* data,std::size_t size,Game& game);
+
+// Memory maps path and replays it 
+ReplayResult replayFile(const std::string& path,Game& game);
@@ -0,0 +1,47 @@
+// Resources.h
+// Defines Resources, which owns every texture and font the front-end uses. Each asset is loaded from disk and uploaded
+// once, the first time it's asked for, and then handed out by reference for the life of the Resources, so nothing
+// ever copies a texture. Records what each asset costs: its GPU memory and how long it took to load
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Resources{
+
+public:
+
+    struct AssetInfo{
+        std::string path;
+        bool font=false; // A font, else a texture 
+        sf::Vector2u size; // Texture size in pixels, 0 for fonts 
+        std::size_t gpuBytes=0; // Texture memory, RGBA8. Fonts upload glyph pages only as text is drawn, so 0 here 
+        std::size_t fileBytes=0;
+        double loadSeconds=0.0; // Reading, decoding and uploading 
+    };
+
+    Resources() = default;
+    Resources(const Resources&)=delete; // Handed out references point into it 
+    Resources& operator=(const Resources&)=delete;
+
+    // Loads path the first time, returns the same object every time after. nullptr if it can't be loaded 
+    const sf::Texture* texture(const std::string& path);
+    const sf::Font* font(const std::string& path);
+
+    const std::vector<AssetInfo>& assets() const { return info; }
+    std::size_t gpuBytes() const; // Every texture together 
+    void report(std::ostream& out) const; // One line per asset, then the totals 
+
+private:
+
+    // Stable addresses, references stay good however many assets are added 
+    std::map<std::string,std::unique_ptr<sf::Texture>> textures;
+    std::map<std::string,std::unique_ptr<sf::Font>> fonts;
+    std::vector<AssetInfo> info; // In load order 
+
+};
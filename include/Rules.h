@@ -0,0 +1,82 @@
+// Rules.h
+// Rules policies for BasicGame ( see Game.h ). A policy is a set of compile time constants, so each variant builds into
+// its own engine with the choices folded away rather than tested on every move:
+//   drawCount     -- Cards each deal turns from the reserve, 1 or 3
+//   recycleLimit  -- Times the stockpile may go back to the reserve, 0 for no limit
+//   scoring       -- How BasicGame::getScore counts, see Scoring
+//   emptyColumn   -- Which cards an empty Tableau pile takes
+// Which card may go on which is looked up in constexpr tables ( Compatibility ) built from the colour and rank rules
+
+#pragma once
+#include <array>
+#include <cstdint>
+
+enum class Scoring : std::uint8_t{
+    None, // getScore stays 0
+    Standard, // +10 a card up to a foundation, +5 waste to Tableau, +5 a card turned over, -15 a foundation card down, -100 a draw one recycle
+    Vegas // -52 to play a deal, +5 a card up to a foundation, -5 one taken back down
+};
+
+enum class EmptyColumn : std::uint8_t{
+    KingOnly, // Klondike proper
+    Any // Any card or run may start an empty pile
+};
+
+template<int Draw,int Recycles,Scoring Score,EmptyColumn Empty>
+struct Rules{
+    static_assert(Draw==1 || Draw==3, "Deals turn one card or three");
+    static_assert(Recycles>=0, "Recycle limit is a count, 0 for none");
+    static constexpr int drawCount=Draw;
+    static constexpr int recycleLimit=Recycles;
+    static constexpr Scoring scoring=Score;
+    static constexpr EmptyColumn emptyColumn=Empty;
+};
+
+using KlondikeRules=Rules<1,0,Scoring::None,EmptyColumn::KingOnly>; // Draw one, no limits, what Game plays
+using DrawThreeRules=Rules<3,0,Scoring::Standard,EmptyColumn::KingOnly>;
+using VegasRules=Rules<3,2,Scoring::Vegas,EmptyColumn::KingOnly>; // Three passes through the stock
+using RelaxedRules=Rules<1,0,Scoring::Standard,EmptyColumn::Any>;
+
+// Card compatibility as bit masks over card indexes ( value | suit<<4, as GameState packs them without face up ), so
+// "may card go on top" is one shift and and
+namespace Compatibility{
+
+constexpr int cardIndex(int suit,int value) { return value | suit<<4; }
+constexpr std::uint64_t bit(int suit,int value) { return std::uint64_t{1}<<cardIndex(suit,value); }
+
+struct Tables{
+    std::array<std::uint64_t,64> tableau{}; // By the top card of a Tableau pile, the cards that may go on it
+    std::array<std::uint64_t,64> foundation{}; // By the top card of a foundation, the one card that may go on it
+    std::uint64_t kings=0;
+    std::uint64_t aces=0;
+    std::uint64_t every=0;
+};
+
+constexpr Tables build(){
+    Tables t{};
+    for (int suit=0;suit<4;suit++){
+        t.kings|=bit(suit,12);
+        t.aces|=bit(suit,0);
+        for (int value=0;value<13;value++){
+            t.every|=bit(suit,value);
+            int top=cardIndex(suit,value);
+            if (value<12) t.foundation[top]=bit(suit,value+1);
+            if (value==0) continue;
+            for (int other=0;other<4;other++){
+                if (other%2!=suit%2) t.tableau[top]|=bit(other,value-1); // Red suits have the property %2==1
+            }
+        }
+    }
+    return t;
+}
+
+inline constexpr Tables tables=build();
+
+// Cards an empty Tableau pile takes under the rules of R
+template<class R>
+constexpr std::uint64_t emptyTableau() { return R::emptyColumn==EmptyColumn::Any ? tables.every : tables.kings; }
+
+static_assert(tables.tableau[cardIndex(0,12)]==(bit(1,11) | bit(3,11)), "A black King takes the red Queens");
+static_assert(tables.foundation[cardIndex(2,0)]==bit(2,1), "A Club Ace takes the Club Two");
+
+}
@@ -0,0 +1,55 @@
+// SessionPool.h
+// Storage for many independent games in one process. Games live in fixed blocks that are allocated once and never
+// freed, a closed session's game goes on a free list and the next session reuses it, card and history storage
+// included. Once the pool has grown to its peak, opening and closing sessions never touch the heap, and play only does
+// when a game outgrows the storage earlier games in its slot left behind.
+// Session ids carry a generation, so an id stays dead after its session closes even once its slot is reused
+
+#pragma once
+#include "Game.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SessionPool{
+
+public:
+
+    static constexpr int slotBits=20; // Low bits of a session id, the slot. The rest is its generation
+    static constexpr std::uint32_t maxSlots=1u<<slotBits;
+
+    explicit SessionPool(std::uint32_t capacity=maxSlots); // capacity -- Most sessions open at once, at most maxSlots
+
+    std::uint32_t open(std::uint64_t seed); // Opens a session dealt game seed, returns its id or 0 if the pool is full
+    bool close(std::uint32_t id); // Returns the session's game to the pool, false if it wasn't open
+    Game* find(std::uint32_t id); // The session's game, nullptr if it isn't open
+
+    // Getters
+    std::uint32_t live() const { return liveCount; }
+    std::uint32_t slots() const { return slotCount; }
+    std::size_t bytes() const; // Blocks plus the storage each game holds
+
+private:
+
+    static constexpr int blockBits=10; // Slots per block, as a power of two
+    static constexpr std::uint32_t noSlot=0xFFFFFFFF;
+
+    struct Slot{
+        Game game;
+        std::uint32_t generation=1; // Never 0, so no id is 0
+        std::uint32_t nextFree=noSlot;
+        bool open=false;
+    };
+
+    Slot& slot(std::uint32_t index) { return blocks[index>>blockBits][index&((1u<<blockBits)-1)]; }
+    const Slot& slot(std::uint32_t index) const { return blocks[index>>blockBits][index&((1u<<blockBits)-1)]; }
+    bool grow(); // Adds a block of slots to the free list, false at capacity
+
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    std::uint32_t capacity;
+    std::uint32_t slotCount=0;
+    std::uint32_t liveCount=0;
+    std::uint32_t freeHead=noSlot;
+
+};
@@ -0,0 +1,63 @@
+// Snapshot.h
+// Saves a whole Game, position, deal number and undo history, to a fixed layout binary file that can be memory mapped
+// and used in place. The file is a SnapshotHeader followed by the history, one Delta ( see Delta.h ) per move:
+//
+//   offset 0    SnapshotHeader, 104 bytes 
+//   offset 104  std::uint16_t history[historyCount] 
+//
+// Every field is little endian. A reader must check magic and version, a change to the layout bumps version
+
+#pragma once
+#include "Game.h"
+#include "GameState.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+struct SnapshotHeader{
+
+    static constexpr char magicBytes[4]={'K','S','S','N'};
+    static constexpr std::uint16_t currentVersion=1;
+
+    char magic[4]; // "KSSN"
+    std::uint16_t version; // currentVersion when written 
+    std::uint16_t headerBytes; // sizeof(SnapshotHeader), where the history starts 
+    std::uint32_t historyCount; // Entries in the history 
+    std::uint32_t historyCursor; // Entries before this are applied, the rest have been undone and can be redone 
+    std::uint64_t dealSeed; // Game::getDealSeed 
+    std::uint64_t hash; // Game::getHash, to catch a damaged position 
+    GameState state; // The position itself, including won 
+    std::uint8_t padding[6]; // Always zero, keeps the size a multiple of 8 
+
+};
+
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "SnapshotHeader is written and mapped as raw bytes");
+static_assert(sizeof(SnapshotHeader)==104, "SnapshotHeader is a file format");
+
+// Writes game to path, replacing it only once the new file is complete. Returns false if it can't be written
+bool saveSnapshot(const Game& game,const std::string& path);
+
+// Loads path into game, returns false and leaves game alone if the file is missing, damaged or another version
+bool loadSnapshot(Game& game,const std::string& path);
+
+// A snapshot file mapped into memory and checked, nothing is copied until restore. Pages of a long history are only
+// read from disk if restore copies them 
+class SnapshotView{
+
+public:
+
+    bool open(const std::string& path); // Maps and checks path, false if it isn't a usable snapshot 
+
+    const SnapshotHeader& header() const { return *reinterpret_cast<const SnapshotHeader*>(file.data()); }
+    const GameState& state() const { return header().state; }
+    const std::uint16_t* history() const { return reinterpret_cast<const std::uint16_t*>(file.data()+sizeof(SnapshotHeader)); }
+
+    // Loads the snapshot into game, with or without its undo history. False if the history doesn't fit the position 
+    bool restore(Game& game,bool withHistory=true) const;
+
+private:
+
+    MappedFile file;
+
+};
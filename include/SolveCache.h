@@ -0,0 +1,103 @@
+// SolveCache.h
+// Persistent cache of Solver verdicts keyed by deal number, so a deal is only ever solved once. The file is a fixed
+// size open addressed hash table, memory mapped shared: any number of processes and threads may read it at once
+// without locking, while writes take a lock on the file so only one writer works at a time.
+//
+// File layout, little endian:
+//   SolveCacheHeader  64 bytes, magic "KSSC", version, slot count ( a power of two )
+//   slots             32 bytes each, four 64 bit words
+//     word 0  bits 0-31 sequence, odd while a writer is in the slot and 0 while it is empty, 32-63 solve microseconds
+//     word 1  deal number
+//     word 2  bits 0-47 nodes the solver expanded, 48-63 solution length
+//     word 3  bits 0-7 SolveResult, the rest reserved
+// Each slot is a seqlock: a writer makes the sequence odd, fills the other words and makes it even again, a reader
+// only trusts what it read if the sequence was even and the same before and after. Slots are never emptied, so new
+// verdicts only ever fill empty slots or overwrite one for a deal that cost less to solve.
+// The table is created at full size as a sparse file, so disk is only used as slots are written.
+
+#pragma once
+#include "Solver.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+struct SolveCacheHeader{
+    char magic[4];
+    std::uint16_t version;
+    std::uint16_t slotBytes;
+    std::uint64_t slotCount;
+    std::uint8_t padding[48];
+};
+static_assert(sizeof(SolveCacheHeader)==64, "SolveCacheHeader is a file format");
+
+struct CachedSolve{
+    SolveResult result=SolveResult::OutOfBudget;
+    std::uint16_t solutionLength=0;
+    std::uint32_t micros=0;
+    std::uint64_t nodes=0; // Positions expanded, for OutOfBudget how far the search got before giving up
+
+    // Whether this answers a search with a node budget ( 0 for none ). A proven verdict always does, giving up only
+    // does if the search already got as far as that budget would
+    bool answers(long long maxNodes) const{
+        return result!=SolveResult::OutOfBudget || (maxNodes>0 && static_cast<std::uint64_t>(maxNodes)<=nodes);
+    }
+};
+
+class SolveCache{
+
+public:
+
+    static constexpr char magicBytes[4]={'K','S','S','C'};
+    static constexpr std::uint16_t currentVersion=1;
+    static constexpr std::uint64_t defaultSlots=1u<<22; // 128 MiB of table, room for millions of deals
+
+    SolveCache() = default;
+    ~SolveCache() { close(); }
+    SolveCache(const SolveCache&)=delete;
+    SolveCache& operator=(const SolveCache&)=delete;
+
+    // Opens path, creating it with slotsWanted slots ( rounded up to a power of two ) if it doesn't exist. An existing cache
+    // keeps its own size. False if it can't be opened or isn't a cache
+    bool open(const std::string& path,std::uint64_t slotsWanted=defaultSlots);
+    void close();
+    bool isOpen() const { return slots!=nullptr; }
+
+    bool lookup(std::uint64_t deal,CachedSolve& entry) const; // Lock free, false on a miss
+    bool store(std::uint64_t deal,const CachedSolve& entry); // Keeps a proven verdict over a give up, false if not open
+
+    // Getters
+    std::uint64_t slotCount() const { return count; }
+    std::size_t fileBytes() const { return length; }
+
+private:
+
+    static constexpr int probeLength=8; // Slots looked at from a deal's home slot, beyond that the least effort one goes
+
+    struct Slot{
+        std::atomic<std::uint64_t> words[4];
+    };
+    static_assert(sizeof(Slot)==32, "Slots are a file format");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Slots are shared between processes, their words must be plain memory");
+
+    std::uint64_t home(std::uint64_t deal) const; // First slot to probe
+    // Platform specific half
+    bool mapFile(const std::string& path,std::uint64_t slotsWanted); // Opens, lays out a new file and maps it
+    void unmapFile();
+    bool lockFile(); // Exclusive, blocks until this process is the only writer
+    void unlockFile();
+
+    unsigned char* bytes=nullptr;
+    std::size_t length=0;
+    Slot* slots=nullptr;
+    std::uint64_t count=0;
+    std::mutex writeLock; // The file lock is per process, this orders the threads within one
+#ifdef _WIN32
+    void* fileHandle=nullptr;
+    void* mappingHandle=nullptr;
+#else
+    int fd=-1;
+#endif
+
+};
@@ -0,0 +1,97 @@
+// Solver.h
+// Defines the Solver, a depth first search over Game's rules that decides whether a deal is winnable
+// Positions already searched are remembered in a TranspositionTable, and moves are tried best first.
+// Deals and recycles are never searched on their own: any card in the stock can be reached by dealing ( and recycling ),
+// so each one is a single search step that expands to the real deals in the solution.
+// Runs are only split to free the card beneath for a foundation, so Unsolvable means no win exists under that pruning.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Game.h"
+#include "Move.h"
+#include "TranspositionTable.h"
+
+enum class SolveResult{ // Outcome of a search 
+    Solved, // A winning line was found 
+    Unsolvable, // Every line was searched and none of them win 
+    OutOfBudget // The node or time budget ran out first 
+};
+
+struct SolverConfig{
+    long long maxNodes=10000000; // Positions to expand before giving up, 0 for no limit 
+    double maxSeconds=30.0; // Wall clock budget, 0 for no limit 
+    std::size_t tableBytes=256u<<20; // Memory the transposition table may grow to 
+    int maxDepth=600; // Longest line searched 
+    bool findShortest=false; // Keep searching after the first solution for shorter ones, until the budget runs out 
+    bool useTable=true; // Skip positions already searched, off only to check the table against a plain exhaustive search 
+};
+
+struct SolverStats{
+    long long nodes=0; // Positions expanded 
+    double seconds=0.0;
+    std::size_t tableBytes=0; // Peak transposition table memory 
+    std::size_t tableEntries=0;
+    double nodesPerSecond() const { return seconds>0.0 ? nodes/seconds : 0.0; }
+};
+
+struct SolveOutcome{
+    SolveResult result=SolveResult::OutOfBudget;
+    std::vector<Move> solution; // Moves from the starting position to a win, in order 
+    bool shortestProven=false; // With findShortest, whether the search finished so no shorter solution exists 
+    SolverStats stats;
+};
+
+const char* solveResultName(SolveResult result); // i.e. "solved"
+
+class ParallelSolver;
+
+class Solver{
+
+public:
+
+    explicit Solver(const SolverConfig& config=SolverConfig());
+
+    SolveOutcome solve(const Game& game); // Searches from game's position, game itself is left untouched 
+
+    // One search step, a card move optionally preceded by deals ( and a recycle ) to bring a stock card to the top
+    struct Step{
+        Move move;
+        std::uint8_t drawsBefore=0; // Deals before the recycle, or before the move if there's no recycle 
+        bool recycle=false;
+        std::uint8_t drawsAfter=0; // Deals after the recycle 
+        int score=0; // Ordering score, higher is tried first 
+        int length() const { return drawsBefore+(recycle ? 1 : 0)+drawsAfter+1; } // Real moves it expands to 
+    };
+
+    // Appends the steps for game's position to steps best first, dropping ones that can never help.
+    // If a foundation move that can never hurt exists, it is the only step added. Returns how many were added.
+    static int generateSteps(const Game& game,std::vector<Step>& steps);
+
+private:
+
+    friend class ParallelSolver; // Drives Solvers as the workers of a parallel search 
+
+    SolverConfig config;
+    TranspositionTable table;
+
+    // Search state
+    Game game;
+    std::vector<Move> path;
+    std::vector<Step> steps; // Steps of every frame on the current line, each frame appends its own 
+    SolveOutcome outcome;
+    std::size_t bestLength=0; // Length of the best solution so far, 0 if none
+    bool stopped=false; // Budget ran out 
+    bool truncated=false; // Some line was cut at maxDepth, so an empty search proves nothing 
+    long long nextClockCheck=0;
+    double startTime=0.0;
+    ParallelSolver* parallel=nullptr; // Set while working on part of a parallel search, which owns the table and budget 
+    long long unchargedNodes=0; // Nodes not yet added to the parallel search's count 
+
+    bool search(int depth);
+    bool outOfBudget();
+    void play(const Step& step); // Applies a step, pushing its real moves onto path 
+    void takeBack(const Step& step); // Undoes a step played by play
+
+};
@@ -1,26 +1,48 @@
 // Spritesheet.h, created by Andrew Gossen.
-// Defines the Spritesheet class used to store textures
+// Defines the Spritesheet class, which cuts card pictures out of the sheet texture. The textures themselves are owned
+// by Resources, the Spritesheet only points at them
+// Every picture on the sheet has a frame number, its texture rectangle is worked out once at load time:
+//   0-51  card faces, value + suit*13 ( see cardFrame )
+//   52-54 the animated card back
+//   55    the reset ( recycle ) card
+// With the atlas built by make atlas loaded ( loadAtlas ), the frames, both buttons and a plain white pixel all come from
+// one texture, so a whole frame can be drawn from it without switching textures
 
 #pragma once 
 #include <SFML/Graphics.hpp>
+#include <array>
 #include "Card.h"
+#include "Resources.h"
 
 class Spritesheet{ 
 
 public:
 
-    // Asset Loaders
+    static constexpr int backFrame0=52; // First of the three backs 
+    static constexpr int resetFrame=55;
+    static constexpr int frameCount=56;
+
+    explicit Spritesheet(Resources& resources) : resources(resources) {}
+
+    // Asset Loaders, each fetches its texture through Resources
     bool loadFromFile(const std::string& filename);
     bool loadUndo(const std::string& filename);
     bool loadNewDeal(const std::string& filename);
+    bool loadAtlas(const std::string& image,const std::string& table); // Everything at once, false leaves the sheet as it was 
+    static std::array<sf::IntRect,frameCount> sheetLayout(sf::Vector2u sheetSize); // Frame rectangles on Spritesheet.png 
 
     // Getters
-    sf::Sprite makeCardSprite(const Card& card) const;
-    sf::Sprite makeBackSprite();
-    sf::Sprite makeResetSprite() const;
-    sf::Sprite getCardSprite(int col, int row) const;
-    sf::Texture getUndo() const { return undo; } 
-    sf::Texture getNewDeal() const { return newDeal; }
+    static int cardFrame(const Card& card) { return static_cast<int>(card.getValue())+static_cast<int>(card.getSuit())*13; }
+    int backFrame(); // The back to show now, advancing the animation once its delay has passed 
+    sf::Time untilNextBack() const { return backCardDelay-backClock.getElapsedTime(); } // Until the animation moves on, 0 or less if it's due 
+    const sf::IntRect& frameRect(int frame) const { return frames[frame]; }
+    const sf::Texture& getTexture() const { return *texture; }
+    const sf::Texture& getUndo() const { return *undo; } 
+    const sf::Texture& getNewDeal() const { return *newDeal; }
+    const sf::IntRect& getUndoRect() const { return undoRect; } // Of getUndo 
+    const sf::IntRect& getNewDealRect() const { return newDealRect; } // Of getNewDeal 
+    sf::Vector2f solidTexel() const { return solid; } // Texture coordinates of a white pixel, for plain colour quads 
+    bool usesAtlas() const { return atlasLoaded; } // Whether cards and buttons share one texture 
     int cardWidth() const { return _cardWidth; }
     int cardHeight() const { return _cardHeight; }
 
@@ -28,11 +50,17 @@ private:
 
     sf::Clock backClock;  // For the deal card animation 
     sf::Time backCardDelay = sf::milliseconds(1000); // Card changes every second 
-    sf::Texture texture;
-    sf::Texture undo;
-    sf::Texture newDeal;
+    int backIndex=0; // Which of the three backs is showing 
+    Resources& resources;
+    const sf::Texture* texture=nullptr; // Owned by resources, set once loaded 
+    std::array<sf::IntRect,frameCount> frames; // Texture rectangle per frame number 
+    const sf::Texture* undo=nullptr;
+    const sf::Texture* newDeal=nullptr;
+    sf::IntRect undoRect;
+    sf::IntRect newDealRect;
+    sf::Vector2f solid;
+    bool atlasLoaded=false;
     int _cardWidth;
     int _cardHeight;
-    int suitRow(Suit s) const;
 
 };
\ No newline at end of file
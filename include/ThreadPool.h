@@ -0,0 +1,56 @@
+// ThreadPool.h
+// Defines a work stealing ThreadPool, each worker runs tasks from its own queue newest first and steals the
+// oldest task from another worker's queue when its own runs dry
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool{
+
+public:
+
+    explicit ThreadPool(int threads=0); // threads -- Worker count, 0 for one per hardware thread 
+    ~ThreadPool(); // Finishes every queued task, then joins the workers 
+
+    ThreadPool(const ThreadPool&)=delete;
+    ThreadPool& operator=(const ThreadPool&)=delete;
+
+    void submit(std::function<void()> task); // Queues a task, on the calling worker's own queue if called from a task 
+    void wait(); // Blocks until every task, including tasks queued by tasks, has finished 
+
+    // Getters
+    int size() const { return static_cast<int>(threads.size()); }
+    int idleWorkers() const { return idle.load(std::memory_order_relaxed); } // Workers waiting for something to do 
+    long queuedTasks() const { return queued.load(std::memory_order_relaxed); } // Tasks no worker has started yet 
+    int currentWorker() const; // Index of this pool's worker running the calling task, -1 outside this pool, even in another one 
+
+private:
+
+    struct Queue{
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues; // One per worker 
+    std::vector<std::thread> threads;
+
+    std::mutex sleepLock;
+    std::condition_variable wake; // Signalled when a task is queued or the pool stops 
+    std::condition_variable done; // Signalled when the last pending task finishes 
+    std::atomic<long> queued{0}; // Tasks sitting in a queue 
+    std::atomic<long> pending{0}; // Tasks queued or running 
+    std::atomic<int> idle{0};
+    std::atomic<unsigned> nextQueue{0}; // Round robin for tasks submitted from outside the pool 
+    bool stopping=false;
+
+    bool take(int self,std::function<void()>& task); // Own queue first, then steal 
+    void run(int self);
+
+};
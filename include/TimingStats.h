@@ -0,0 +1,33 @@
+// TimingStats.h
+// Collects durations, i.e. frame times or latencies, and reports their percentiles
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+class TimingStats{
+
+public:
+
+    void add(double seconds) { samples.push_back(seconds); }
+    void clear() { samples.clear(); }
+    void merge(const TimingStats& other) { samples.insert(samples.end(),other.samples.begin(),other.samples.end()); }
+    std::size_t count() const { return samples.size(); }
+
+    // p -- 0 to 1, i.e. 0.99 for the 99th percentile. 0 if nothing was added 
+    double percentile(double p) const{
+        if (samples.empty()) return 0.0;
+        std::vector<double> sorted=samples;
+        std::size_t rank=static_cast<std::size_t>(p*(sorted.size()-1)+0.5);
+        std::nth_element(sorted.begin(),sorted.begin()+rank,sorted.end());
+        return sorted[rank];
+    }
+
+    double max() const { return samples.empty() ? 0.0 : *std::max_element(samples.begin(),samples.end()); }
+
+private:
+
+    std::vector<double> samples;
+
+};
@@ -0,0 +1,75 @@
+// TranspositionTable.h
+// Defines the TranspositionTable used by the Solver to remember positions it has already searched
+// Open addressing over 64 bit slots, each slot packs the upper bits of a position hash with the depth it was reached at.
+// The top bit of a slot marks it used, so an entry is never 0
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class TranspositionTable{
+
+public:
+
+    // maxBytes -- Memory the table may grow to, it starts small and doubles as it fills 
+    explicit TranspositionTable(std::size_t maxBytes);
+
+    // Records that a position was reached at depth, returns false if it was already reached at the same depth or shallower,
+    // in which case there is nothing new to search below it
+    bool visit(std::uint64_t hash,int depth);
+
+    void clear(); // Forgets every position, keeping the current allocation 
+
+    // Getters
+    std::size_t bytes() const { return slots.size()*sizeof(std::uint64_t); } // Current ( and peak, it never shrinks ) memory use
+    std::size_t entries() const { return used; }
+    std::size_t evictions() const { return evicted; }
+
+    static constexpr int depthBits=10; // Low bits of a slot hold the depth, the rest are hash bits 
+    static constexpr int maxDepth=(1<<depthBits)-1; // Deepest depth a slot can store 
+
+private:
+
+    static constexpr std::uint64_t depthMask=(1ull<<depthBits)-1;
+    static constexpr int probeLength=8; // Slots tried before replacing the deepest entry seen 
+
+    std::vector<std::uint64_t> slots; // 0 marks an empty slot
+    std::size_t maxSlots;
+    std::size_t used=0;
+    std::size_t evicted=0;
+
+    void grow();
+    void insert(std::uint64_t slot);
+
+};
+
+
+// Thread safe version of TranspositionTable shared by every thread of a parallel search.
+// Slots are updated with compare and swap, the table is allocated at its full size up front and never grows.
+class ConcurrentTranspositionTable{
+
+public:
+
+    explicit ConcurrentTranspositionTable(std::size_t maxBytes); // maxBytes -- Memory for the table 
+
+    bool visit(std::uint64_t hash,int depth); // As TranspositionTable::visit, safe to call from any thread 
+    void clear(); // Not safe to call while other threads are visiting 
+
+    // Getters
+    std::size_t bytes() const { return slotCount*sizeof(std::uint64_t); }
+    std::size_t entries() const { return used.load(std::memory_order_relaxed); }
+
+private:
+
+    static constexpr int depthBits=TranspositionTable::depthBits;
+    static constexpr std::uint64_t depthMask=(1ull<<depthBits)-1;
+    static constexpr int probeLength=8;
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+    std::size_t slotCount;
+    std::atomic<std::size_t> used{0};
+
+};
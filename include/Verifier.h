@@ -0,0 +1,40 @@
+// Verifier.h
+// Checks claimed solutions for fixed deal competitions. A submission is one line of text, the deal number and then
+// every move in the notation of Notation.h, separated by spaces:
+//
+//   1234 draw w>t3 t6>f0 t2:4>t5 ...
+//
+// A submission is accepted only if every move is legal in turn and the game is won after the last one. Moves go
+// straight to Game::applyMove, so a line costs a deal plus one parse and applyMove per move. Batches of lines are
+// spread over a ThreadPool, each worker reusing one Game.
+
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "Game.h"
+#include "ThreadPool.h"
+
+enum class VerifyResult : std::uint8_t{
+    Won=0,
+    NotWon, // Every move was legal but the game isn't won after the last
+    Illegal, // A move isn't legal in the position it's made in
+    Unreadable, // A move isn't in the notation, or names a card that isn't there
+    NoDeal, // The line doesn't start with a deal number
+    Skipped // A blank line or a comment, not a submission
+};
+
+struct Verdict{
+    VerifyResult result=VerifyResult::NoDeal;
+    std::uint32_t moves=0; // Moves made, so for Illegal and Unreadable the index of the offending move
+    std::uint32_t offset=0; // Where the offending move starts in the line
+    std::uint32_t length=0; // Its length
+};
+
+const char* verifyResultName(VerifyResult result); // i.e. "illegal"
+
+// -- Replays one submission into game, blank lines and lines starting with '#' are Skipped
+Verdict verifySubmission(std::string_view line,Game& game);
+
+// -- Verifies every line on pool, verdicts[i] for lines[i]
+void verifyBatch(ThreadPool& pool,const std::vector<std::string_view>& lines,std::vector<Verdict>& verdicts);
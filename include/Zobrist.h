@@ -0,0 +1,35 @@
+// Zobrist.h
+// Random 64 bit keys for Zobrist hashing a position. A position's hash is the xor of one key per card, picked by the
+// card, the pile it sits in and how deep, plus one more key per face up card. Moving or flipping a card then only
+// needs the keys of that card xored in and out, rather than rehashing all 52
+
+#pragma once
+#include <cstdint>
+
+namespace Zobrist{
+
+    constexpr int cardCount=52;
+    constexpr int pileCount=13; // GameState::PileCount 
+    constexpr int maxPileSize=24; // The reserve, at the start of a game, is the deepest any pile gets 
+
+    struct Keys{
+        std::uint64_t place[cardCount][pileCount][maxPileSize];
+        std::uint64_t faceUp[cardCount];
+    };
+
+    const Keys& keys(); // Filled once from a fixed seed, so hashes match between runs and machines 
+
+    // Card number, 0-51, of a card 
+    inline int cardId(int suit,int value) { return suit*13+value; }
+
+    // Key for a card at a place in the game
+    // card -- cardId of the card 
+    // pile -- GameState::Pile id the card is in 
+    // index -- How deep in the pile, 0 is the bottom 
+    // faceUp -- Whether the card is face up 
+    inline std::uint64_t key(int card,int pile,int index,bool faceUp){
+        const Keys& k=keys();
+        return k.place[card][pile][index]^(faceUp ? k.faceUp[card] : 0);
+    }
+
+}
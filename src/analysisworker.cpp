@@ -0,0 +1,158 @@
+// analysisworker.cpp
+// Background hint computation, see AnalysisWorker.h
+
+#include "AnalysisWorker.h"
+#include <algorithm>
+#include <vector>
+
+AnalysisWorker::AnalysisWorker(const AnalysisConfig& config)
+: config(config), engine([&]{ HintConfig hint=config.hint; hint.samples=config.batchSamples; hint.maxSeconds=0.0; return hint; }(),config.threads),
+  thread([this]{ run(); }) {}
+
+AnalysisWorker::~AnalysisWorker(){
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping=true;
+        cancel.store(true,std::memory_order_relaxed);
+    }
+    wake.notify_one();
+    thread.join();
+
+}
+
+void AnalysisWorker::submit(const GameState& state,std::uint64_t revision){
+
+    // state -- The new position 
+    // revision -- Its revision 
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pending=state;
+        pendingRevision=revision;
+        submittedAt=std::chrono::steady_clock::now();
+        hasPending=true;
+        working.store(true,std::memory_order_release);
+        cancel.store(true,std::memory_order_relaxed);
+    }
+    wake.notify_one();
+
+}
+
+void AnalysisWorker::stop(){
+    std::lock_guard<std::mutex> guard(lock);
+    hasPending=false;
+    cancel.store(true,std::memory_order_relaxed); // busy() clears once the worker notices 
+}
+
+// Word layout: bits 0-31 revision, 32-39 move index, 40-46 win percent, 47 valid, 48-63 samples 
+std::uint64_t AnalysisWorker::pack(const Suggestion& s){
+    return static_cast<std::uint64_t>(s.revision)
+        | static_cast<std::uint64_t>(s.moveIndex&0xFF)<<32
+        | static_cast<std::uint64_t>(s.winPercent&0x7F)<<40
+        | static_cast<std::uint64_t>(s.valid ? 1 : 0)<<47
+        | static_cast<std::uint64_t>(std::min(s.samples,0xFFFF))<<48;
+}
+
+AnalysisWorker::Suggestion AnalysisWorker::unpack(std::uint64_t word){
+    Suggestion s;
+    s.revision=static_cast<std::uint32_t>(word);
+    s.moveIndex=static_cast<int>((word>>32)&0xFF);
+    s.winPercent=static_cast<int>((word>>40)&0x7F);
+    s.valid=((word>>47)&1)!=0;
+    s.samples=static_cast<int>(word>>48);
+    return s;
+}
+
+AnalysisWorker::Suggestion AnalysisWorker::suggestion() const{
+    return unpack(published.load(std::memory_order_acquire));
+}
+
+bool AnalysisWorker::suggestedMove(const Game& game,Move& move) const{
+
+    // game -- The game as the render loop sees it now 
+    // move -- Set to the suggested move 
+
+    Suggestion s=suggestion();
+    if (!s.valid || s.revision!=static_cast<std::uint32_t>(game.getRevision())) return false; // Not for this position ( yet )
+    Game::MoveBuffer moves;
+    if (s.moveIndex>=game.generateMoves(moves)) return false;
+    move=moves[s.moveIndex];
+    return true;
+
+}
+
+TimingStats AnalysisWorker::latency() const{
+    std::lock_guard<std::mutex> guard(statsLock);
+    return latencies;
+}
+
+void AnalysisWorker::run(){
+
+    Game game;
+    std::vector<int> wins;
+    std::vector<int> samples;
+
+    for (;;){
+
+        // Wait for a position, then own it 
+        std::uint64_t revision;
+        std::chrono::steady_clock::time_point submitted;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard,[&]{ return hasPending || stopping; });
+            if (stopping) return;
+            game.setState(pending);
+            revision=pendingRevision;
+            submitted=submittedAt;
+            hasPending=false;
+            cancel.store(false,std::memory_order_relaxed);
+        }
+
+        Game::MoveBuffer moves;
+        int count=game.generateMoves(moves);
+        wins.assign(count,0);
+        samples.assign(count,0);
+        bool first=true;
+
+        // Refine a batch at a time until the sample target is met or a newer position arrives 
+        for (int done=0;done<config.hint.samples && !cancel.load(std::memory_order_relaxed);done+=config.batchSamples){
+            HintReport report=engine.hint(game,&cancel,static_cast<std::uint64_t>(done));
+            if (report.cancelled || report.samples==0) break;
+            for (const MoveHint& hint : report.moves){
+                wins[hint.index]+=hint.wins;
+                samples[hint.index]+=hint.samples;
+            }
+
+            Suggestion best;
+            best.revision=static_cast<std::uint32_t>(revision);
+            for (int i=0;i<count;i++){
+                if (!best.valid || wins[i]>wins[best.moveIndex]){
+                    best.valid=true;
+                    best.moveIndex=i;
+                }
+            }
+            if (best.valid){
+                best.samples=samples[best.moveIndex];
+                best.winPercent=best.samples ? (100*wins[best.moveIndex]+best.samples/2)/best.samples : 0;
+            }
+            published.store(pack(best),std::memory_order_release);
+
+            if (first){
+                std::lock_guard<std::mutex> guard(statsLock);
+                latencies.add(std::chrono::duration<double>(std::chrono::steady_clock::now()-submitted).count());
+                first=false;
+            }
+        }
+
+        if (count==0){ // Nothing to suggest, say so for this revision 
+            Suggestion none;
+            none.revision=static_cast<std::uint32_t>(revision);
+            published.store(pack(none),std::memory_order_release);
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        if (!hasPending) working.store(false,std::memory_order_release); // Finished, and nothing newer waiting 
+    }
+
+}
@@ -0,0 +1,93 @@
+// atlas.cpp
+// Atlas table file and shelf packer, see Atlas.h
+
+#include "Atlas.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+bool AtlasTable::load(const std::string& path){
+
+    // path -- Table written by save, i.e. "assets/atlas.bin"
+
+    std::ifstream in(path,std::ios::binary);
+    if (!in) return false;
+    AtlasHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header),sizeof(header))) return false;
+    if (std::memcmp(header.magic,magicBytes,sizeof(header.magic))!=0 || header.version!=currentVersion
+        || header.entryBytes!=sizeof(AtlasEntry)) return false;
+
+    std::vector<AtlasEntry> read(header.entryCount);
+    if (header.entryCount>0 && !in.read(reinterpret_cast<char*>(read.data()),static_cast<std::streamsize>(read.size()*sizeof(AtlasEntry)))) return false;
+    for (std::size_t i=0;i<read.size();i++){ // Every entry inside the image, keys strictly increasing so find can bisect
+        const AtlasEntry& entry=read[i];
+        if (entry.x+entry.width>header.width || entry.y+entry.height>header.height) return false;
+        if (i>0 && read[i-1].key>=entry.key) return false;
+    }
+
+    width=header.width;
+    height=header.height;
+    entries=std::move(read);
+    return true;
+
+}
+
+bool AtlasTable::save(const std::string& path) const{
+
+    // path -- Where to write it, replaced if it exists
+
+    AtlasHeader header{};
+    std::memcpy(header.magic,magicBytes,sizeof(header.magic));
+    header.version=currentVersion;
+    header.entryBytes=sizeof(AtlasEntry);
+    header.entryCount=static_cast<std::uint32_t>(entries.size());
+    header.width=width;
+    header.height=height;
+
+    std::ofstream out(path,std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header),sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()),static_cast<std::streamsize>(entries.size()*sizeof(AtlasEntry)));
+    return static_cast<bool>(out);
+
+}
+
+void AtlasTable::add(const AtlasEntry& entry){
+    auto at=std::lower_bound(entries.begin(),entries.end(),entry.key,[](const AtlasEntry& e,std::uint32_t key){ return e.key<key; });
+    if (at!=entries.end() && at->key==entry.key) *at=entry;
+    else entries.insert(at,entry);
+}
+
+const AtlasEntry* AtlasTable::find(std::uint32_t key) const{
+    auto at=std::lower_bound(entries.begin(),entries.end(),key,[](const AtlasEntry& e,std::uint32_t k){ return e.key<k; });
+    return at!=entries.end() && at->key==key ? &*at : nullptr;
+}
+
+unsigned packShelves(std::vector<AtlasRect>& rects,unsigned width,unsigned padding){
+
+    // rects -- What to place, each gets its x and y
+    // width -- Atlas width in pixels
+    // padding -- Gap left around every rectangle
+
+    // Tallest first keeps shelves from wasting much above their shorter rectangles
+    std::vector<std::size_t> order(rects.size());
+    std::iota(order.begin(),order.end(),0);
+    std::stable_sort(order.begin(),order.end(),[&](std::size_t a,std::size_t b){ return rects[a].height>rects[b].height; });
+
+    unsigned x=padding, y=padding, shelfHeight=0;
+    for (std::size_t index : order){
+        AtlasRect& rect=rects[index];
+        if (rect.width+2*padding>width) return 0;
+        if (x+rect.width+padding>width){ // Full, start the next shelf
+            y+=shelfHeight+padding;
+            x=padding;
+            shelfHeight=0;
+        }
+        rect.x=x;
+        rect.y=y;
+        x+=rect.width+padding;
+        shelfHeight=std::max(shelfHeight,rect.height);
+    }
+    return y+shelfHeight+padding;
+
+}
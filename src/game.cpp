@@ -5,423 +5,703 @@
 // Essential headers
 #include "Game.h"
 #include "Card.h"
+#include "Delta.h"
+#include "Zobrist.h"
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
 #include <random>
-#include <iostream> // Debugging remove later 
 
 
 // -------- Game events 
 
-void Game::resetStockpile(){ 
+template<class Rules>
+void BasicGame<Rules>::resetStockpile(){ 
     
     // -- Resets the stockpile and returns all cards back to the reserve 
 
     if (stockpile.empty()) return;
     if (!reserve.empty()) return;
+    if (!canRecycle()) return;
 
-    while (!stockpile.empty()) {
-        Card c = stockpile.back();           
-        c.setLocation(Location::Reserve);
-        reserve.insert(reserve.end(), c);  
-        stockpile.pop_back();               
-    }
+    play(GameState::Stockpile,GameState::Reserve,static_cast<int>(stockpile.size()));
+}
+
+template<class Rules>
+bool BasicGame<Rules>::canRecycle() const{
+    if constexpr (Rules::recycleLimit==0) return true;
+    else return recycles<Rules::recycleLimit;
 }
 
-void Game::dealNewGame(){
+template<class Rules>
+void BasicGame<Rules>::dealNewGame(){
     
-    // -- Completely erases the current game state and gives the player new cards, also used for initialisation
-
-    if (!stockpile.empty())  stockpile.clear();
-    if (!reserve.empty())  reserve.clear();
-    if (!moveHistory.empty())  moveHistory.clear();
-    for (int i=0;i<7;i++){
-        if (i<=3) { 
-            if (!foundations.empty()) foundations[i].clear(); 
-        }
-        if (!tableau.empty()) tableau[i].clear();
+    // -- Deals a random game, also used for initialisation
+
+    static std::mt19937_64 seeder(std::random_device{}()); // Tick dependant RNG, only picks the deal number, once per game 
+    dealNewGame(seeder());
+
+}
+
+template<class Rules>
+void BasicGame<Rules>::dealNewGame(std::uint64_t seed){
+    
+    // -- Completely erases the current game state and deals game number seed, the same seed always gives the same deal
+    // on every machine, see GameState::dealt for how 
+    // seed -- The deal number 
+
+    setState(GameState::dealt(seed));
+    dealSeed=seed;
+
+}
+
+template<class Rules>
+void BasicGame<Rules>::dealFromReserve(){ 
+
+    // ----- Deals Rules::drawCount cards, or what's left, from the reserve to the 'dealing area'
+
+    if (reserve.empty()) return; // The reserve is empty, so return to avoid seg fault 
+
+    int count=1;
+    if constexpr (Rules::drawCount>1) count=std::min(Rules::drawCount,static_cast<int>(reserve.size()));
+    play(GameState::Reserve,GameState::Stockpile,count); // Goes from Back of Stock -> Front of stockpile, i.e. last index is currently shown card
+
+}
+
+// -------- State conversion
+
+template<class Rules>
+GameState BasicGame<Rules>::getState() const{
+
+    // -- Packs every pile into a GameState, card metadata ( Location, indexes ) is implied by where a card sits
+
+    GameState state;
+    int n=0;
+    auto packPile=[&](const std::vector<Card>& pile,int pileId){
+        for (const Card& c : pile) state.cards[n++]=GameState::packCard(c);
+        state.pileEnd[pileId]=static_cast<std::uint8_t>(n);
     };
 
-    // Create the possible 52 cards 
-    for (int s = 0; s < 4; ++s) { 
-        for (int v = 0; v < 13; ++v) {
-            reserve.push_back(Card{
-                static_cast<Suit>(s),
-                static_cast<Value>(v),
-                false,
-                Location::Reserve, 
-                false
-            });
-        }
-    }
+    packPile(reserve,GameState::Reserve);
+    packPile(stockpile,GameState::Stockpile);
+    for (int i=0;i<7;i++) packPile(tableau[i],GameState::Tableau0+i);
+    for (int i=0;i<4;i++) packPile(foundations[i],GameState::Foundation0+i);
+    state.won=won ? 1 : 0;
+    return state;
+
+}
 
-    static std::mt19937 rng(std::random_device{}()); // Tick dependant RNG 
-    std::shuffle(reserve.begin(), reserve.end(), rng); // Shuffle stockpile to make it random 
-
-    // Assign cards to Tableau, rest will remain in the reserve
-    for (int p=0;p<7;p++){ // Pile iteration
-        for (int c=0;c<(p+1);c++){ // Assign cards to the pile 
-            Card card=reserve.back();
-            card.setLocation(Location::Tableau);
-            reserve.pop_back();
-            tableau[p].push_back(card);
-            if (c==p){
-                tableau[p][c].setFaceUp(true); // End cards will be faceUp by default 
+template<class Rules>
+void BasicGame<Rules>::setState(const GameState& state){
+
+    // -- Rebuilds every pile from a GameState, restoring each card's Location and pile indexes
+    // state -- The position to load 
+
+    auto unpackPile=[&](std::vector<Card>& pile,int pileId,Location location){
+        pile.clear();
+        const std::uint8_t* cards=state.pileBegin(pileId);
+        for (int i=0;i<state.pileSize(pileId);i++){
+            Card c=GameState::unpackCard(cards[i],location);
+            if (location==Location::Tableau){
+                c.setTableauPile(pileId-GameState::Tableau0);
+                c.setTableauIndex(i);
+            } else if (location==Location::Foundation){
+                c.setFoudationPile(pileId-GameState::Foundation0);
             }
-            tableau[p][c].setTableauPile(p);
-            tableau[p][c].setTableauIndex(c);
+            pile.push_back(c);
         }
-    }
+    };
 
-    return;
+    unpackPile(reserve,GameState::Reserve,Location::Reserve);
+    unpackPile(stockpile,GameState::Stockpile,Location::Stockpile);
+    for (int i=0;i<7;i++) unpackPile(tableau[i],GameState::Tableau0+i,Location::Tableau);
+    for (int i=0;i<4;i++) unpackPile(foundations[i],GameState::Foundation0+i,Location::Foundation);
+    won=state.won!=0;
+    history.clear();
+    historyCursor=0;
+    score=startingScore();
+    recycles=0;
+    dirtyPiles=0xFFFF;
+    waitingOn.fill(0);
+    hash=computeHash();
+    revision++;
+    for (std::uint32_t& r : pileRevisions) r++;
 
 }
 
-void Game::dealFromReserve(){ 
+template<class Rules>
+bool BasicGame<Rules>::setHistory(const std::uint16_t* entries,std::size_t count,std::size_t cursor){
 
-    // ----- Deals a card from the reserve to the 'dealing area'
+    // -- Replaces the undo history with one saved alongside the current position, i.e. from a snapshot. Walks the pile
+    // sizes through every entry first, so a damaged history is refused rather than undone into empty piles 
+    // entries -- Delta per move, oldest first 
+    // count -- How many entries 
+    // cursor -- Entries before this had been applied, the rest undone 
 
-    if (reserve.empty()) return; // The reserve is empty, so return to avoid seg fault 
-
-    Card c = reserve.back(); // Deal from the back of the reserve 
-    c.setLocation(Location::Stockpile);
-    reserve.pop_back();
-    stockpile.push_back(c); // Goes from Back of Stock -> Front of stockpile, i.e. last index is currently shown card
+    if (cursor>count) return false;
 
-    // Log the move for the Undo function
-    Move move(
-        c,
-        Location::Reserve,
-        Location::Stockpile,
-        -1,-1
-    );
+    auto fits=[](std::uint16_t delta){
+        int from=Delta::from(delta), to=Delta::to(delta), moved=Delta::count(delta);
+        return from<GameState::PileCount && to<GameState::PileCount && from!=to && moved>0 && (delta>>15)==0;
+    };
 
-    logMove(c,move);
+    int size[GameState::PileCount];
+    for (int i=0;i<GameState::PileCount;i++) size[i]=static_cast<int>(pile(i).size());
+    for (std::size_t i=cursor;i-->0;){ // Undo back to the start 
+        std::uint16_t delta=entries[i];
+        if (!fits(delta)) return false;
+        int from=Delta::from(delta), to=Delta::to(delta), moved=Delta::count(delta);
+        if (size[to]<moved || (Delta::revealed(delta) && size[from]==0) || size[from]+moved>Zobrist::maxPileSize) return false;
+        size[to]-=moved;
+        size[from]+=moved;
+    }
+    for (int i=0;i<GameState::PileCount;i++) size[i]=static_cast<int>(pile(i).size());
+    for (std::size_t i=cursor;i<count;i++){ // Redo to the end 
+        std::uint16_t delta=entries[i];
+        if (!fits(delta)) return false;
+        int from=Delta::from(delta), to=Delta::to(delta), moved=Delta::count(delta);
+        if (size[from]<moved || (Delta::revealed(delta) && size[from]==moved) || size[to]+moved>Zobrist::maxPileSize) return false;
+        size[from]-=moved;
+        size[to]+=moved;
+    }
 
+    history.assign(entries,entries+count);
+    historyCursor=cursor;
+    score=startingScore();
+    recycles=0;
+    for (std::size_t i=0;i<cursor;i++) account(history[i],1); // The history runs from the deal 
+    return true;
 
 }
 
 // -------- Helper Functions 
 
-void Game::pushToTableau(const Move &move,Card card,std::vector<Card> &popBackArray){
-
-    // --- Puts a card into a Tableau pile and pushes it back from the popBackArray 
-    // move -- Constant move object,
-    // card -- Card object which we will append to the Tableau and remove from popBackArray
-    // popBackArray -- The array we want to push back from, i.e. the array being removed of the card 
-
-    card.setLocation(Location::Tableau);
-    card.setFaceUp(true);
-    card.setTableauIndex(tableau[move.getPile()].size());
-    card.setTableauPile(move.getPile());
-    card.setFoudationPile(-1);
-    tableau[move.getPile()].push_back(card);
-    popBackArray.pop_back();
-    popBackArray.back().setFaceUp(true);
-}
+template<class Rules>
+std::vector<Card>& BasicGame<Rules>::pile(int id){
 
-// --- Puts a card into the stockpile and pushes it back from the popBackArray 
-void Game::pushToStockpile(Card card,std::vector<Card> &popBackArray){
+    // -- Maps a GameState::Pile id to the pile's array 
 
-    // move -- Constant move object,
-    // card -- Card object which we will append to the stockpile and remove from popBackArray
-    // popBackArray -- The array we want to push back from, i.e. the array being removed of the card 
+    if (id==GameState::Reserve) return reserve;
+    if (id==GameState::Stockpile) return stockpile;
+    if (id<GameState::Foundation0) return tableau[id-GameState::Tableau0];
+    return foundations[id-GameState::Foundation0];
+}
 
-    card.setLocation(Location::Stockpile);
-    card.setFaceUp(true);
-    card.setTableauIndex(-1);
-    card.setTableauPile(-1);
-    card.setFoudationPile(-1);
-    stockpile.push_back(card);
-    popBackArray.pop_back();
+template<class Rules>
+void BasicGame<Rules>::transfer(int from,int to,int count){
+
+    // -- Moves the top count cards of one pile onto another and updates each card's Location and indexes. Cards move as a
+    // block, except between the stockpile and reserve where they go one at a time, reversing their order as a real deal does
+    // from -- GameState::Pile id the cards come from 
+    // to -- GameState::Pile id the cards go to 
+    // count -- How many cards 
+
+    std::vector<Card>& source=pile(from);
+    std::vector<Card>& destination=pile(to);
+    int first=static_cast<int>(source.size())-count;
+    bool oneAtATime=(from==GameState::Reserve || from==GameState::Stockpile) && (to==GameState::Reserve || to==GameState::Stockpile);
+
+    Location location=Location::Tableau;
+    if (to==GameState::Reserve) location=Location::Reserve;
+    else if (to==GameState::Stockpile) location=Location::Stockpile;
+    else if (to>=GameState::Foundation0) location=Location::Foundation;
+
+    for (int i=0;i<count;i++){
+        int index=oneAtATime ? static_cast<int>(source.size())-1-i : first+i;
+        Card c=source[index];
+        hash^=cardKey(c,from,index); // Out of its old place 
+        c.setLocation(location);
+        c.setFaceUp(location!=Location::Reserve); // Only reserve cards are face down 
+        c.setTableauPile(location==Location::Tableau ? to-GameState::Tableau0 : -1);
+        c.setTableauIndex(location==Location::Tableau ? static_cast<int>(destination.size()) : -1);
+        c.setFoudationPile(location==Location::Foundation ? to-GameState::Foundation0 : -1);
+        hash^=cardKey(c,to,static_cast<int>(destination.size())); // Into the new one 
+        destination.push_back(c);
+    }
+    source.resize(first);
+
+    pileRevisions[from]++;
+    pileRevisions[to]++;
+    dirtyPiles|=static_cast<std::uint16_t>((1u<<from) | (1u<<to));
+    if (to>=GameState::Foundation0 && count>0){ // A foundation grew, wake the piles waiting on its suit 
+        int suit=static_cast<int>(destination.back().getSuit());
+        dirtyPiles|=waitingOn[suit];
+        waitingOn[suit]=0;
+    }
 }
 
-void Game::logMove(Card c,Move originalMove){
+template<class Rules>
+void BasicGame<Rules>::play(int from,int to,int count,bool grouped){
 
-    // ---- Creates a move for logging, utilised by the undo function
-    // c -- The card we want to log the move for 
-    // originalMove -- The original move object, all that changes for the undo function is the card as we adjust it's stored indexs ( TableauPileIndex, TableauIndex, FoundationPile )
+    // -- Makes a move that has already been checked, turning over the card it uncovers, and logs it for undo.
+    // Anything that was undone and not redone is forgotten
+    // from -- GameState::Pile id the cards come from 
+    // to -- GameState::Pile id the cards go to 
+    // count -- How many cards 
+    // grouped -- Undo and redo this move together with the one before it 
 
-    Move newMove(
-        c,
-        originalMove.getStartingPosition(),
-        originalMove.getDestination(),
-        originalMove.getPile(),
-        originalMove.getStartingPile()
-    );
-    moveHistory.push_back(newMove);
+    transfer(from,to,count);
 
+    bool revealed=false;
+    std::vector<Card>& source=pile(from);
+    if (from>=GameState::Tableau0 && from<GameState::Foundation0 && !source.empty() && !source.back().getFaceUp()){
+        turnTop(from,true); // Reveal the card underneath 
+        revealed=true;
+    }
+
+    history.resize(historyCursor);
+    history.push_back(Delta::encode(from,to,count,revealed,grouped));
+    historyCursor++;
+    account(history.back(),1);
+    updateWon();
+    revision++;
+    checkHash("play");
 }
 
-// ------ Logic functions 
+template<class Rules>
+void BasicGame<Rules>::turnTop(int id,bool faceUp){
 
-void Game::FoundationLogic(const Move& move, const Card& movingCard,std::vector<Card> &popBackArray,bool undo){ 
+    // -- Turns the top card of a pile face up or down
+    // id -- GameState::Pile id 
+    // faceUp -- Which way up it ends 
 
-    // -- Applies Foundation Logic, cards can only move up to the foundation if they are the same suit and one value higher 
+    Card& c=pile(id).back();
+    if (c.getFaceUp()==faceUp) return;
+    c.setFaceUp(faceUp);
+    hash^=Zobrist::keys().faceUp[Zobrist::cardId(static_cast<int>(c.getSuit()),static_cast<int>(c.getValue()))];
+}
 
-    // This is assuming that movingCard is not connected to any other cards 
-    // (i.e. not a Tableau drag with multiple cards involved).
+template<class Rules>
+void BasicGame<Rules>::account(std::uint16_t delta,int sign){
 
-    // move -- Move object on which the logic is based on 
-    // movingCard -- The card object we want to move 
-    // popBackArray -- The array we're taking the card from 
-    // undo -- Whether this is apart of an 'Undo' where the player has clicked the undo button 
-            
-    int cardValue=static_cast<int>(movingCard.getValue());
-    bool proceed=false;
-    
-    if (foundations[move.getPile()].empty()){
-        if (cardValue==0){ // Ace 
-            // Move to foundation pile as we're moving an ace to an empty foundation pile
-            proceed=true;
-        }
+    // -- Everything a history entry changes besides the cards, so undo and redo keep it exact 
+    // delta -- The entry 
+    // sign -- 1 as it's made or redone, -1 as it's undone 
+
+    if constexpr (Rules::scoring!=Scoring::None) score+=sign*scoreOf(delta);
+    if constexpr (Rules::recycleLimit>0){
+        if (Delta::from(delta)==GameState::Stockpile && Delta::to(delta)==GameState::Reserve) recycles+=sign;
+    }
+}
+
+template<class Rules>
+int BasicGame<Rules>::scoreOf(std::uint16_t delta){
+
+    // -- Points a history entry is worth under Rules::scoring, see Scoring in Rules.h 
+
+    int from=Delta::from(delta), to=Delta::to(delta);
+    int points=0;
+    if constexpr (Rules::scoring==Scoring::Vegas){
+        if (to>=GameState::Foundation0) points+=5;
+        if (from>=GameState::Foundation0) points-=5;
+    } else if constexpr (Rules::scoring==Scoring::Standard){
+        if (to>=GameState::Foundation0) points+=10;
+        if (from>=GameState::Foundation0) points-=15;
+        if (from==GameState::Stockpile && to>=GameState::Tableau0 && to<GameState::Foundation0) points+=5;
+        if (Delta::revealed(delta)) points+=5;
+        if (Rules::drawCount==1 && from==GameState::Stockpile && to==GameState::Reserve) points-=100;
     } else {
-        Card& foundationCard=foundations[move.getPile()].back();
-        int foundationValue=static_cast<int>(foundationCard.getValue());
-        if (foundationCard.getSuit()==movingCard.getSuit() && cardValue==foundationValue+1){
-            // Move to foundation as we're moving the same suit but one higher than current top-most foundation card
-            proceed=true;
-        }
+        (void)from;
+        (void)to;
     }
+    return points;
+}
+
+template<class Rules>
+std::uint64_t BasicGame<Rules>::cardKey(const Card& c,int pileId,int index){
+
+    // -- Zobrist key of a card at index in pile pileId 
+
+    return Zobrist::key(Zobrist::cardId(static_cast<int>(c.getSuit()),static_cast<int>(c.getValue())),pileId,index,c.getFaceUp());
+}
+
+template<class Rules>
+std::uint64_t BasicGame<Rules>::computeHash() const{
+
+    // -- Hashes the position from scratch, what getHash should always equal 
+
+    std::uint64_t full=0;
+    auto hashPile=[&](const std::vector<Card>& cards,int pileId){
+        for (int i=0;i<static_cast<int>(cards.size());i++) full^=cardKey(cards[i],pileId,i);
+    };
 
-    if (proceed){
+    hashPile(reserve,GameState::Reserve);
+    hashPile(stockpile,GameState::Stockpile);
+    for (int i=0;i<7;i++) hashPile(tableau[i],GameState::Tableau0+i);
+    for (int i=0;i<4;i++) hashPile(foundations[i],GameState::Foundation0+i);
+    return full;
+}
 
-        Card c=movingCard;
-        c.setLocation(Location::Foundation);
-        c.setTableauPile(-1);
-        c.setTableauIndex(-1);
-        c.setFoudationPile(move.getPile());
-        c.setFaceUp(true);
-        foundations[move.getPile()].push_back(c);
-        popBackArray.pop_back();
+template<class Rules>
+void BasicGame<Rules>::checkHash(const char* where) const{
 
-        if(!undo){
-            // Create a clone card with the new pile and index so we can create a 'flipped' move in case the player Undoes
-            Card clone=c;
-            logMove(clone,move);
-        } 
+    // -- With SOLITAIRE_CHECK_HASH defined, stops the program if the incremental hash has drifted from a full recompute,
+    // naming the function that left it wrong. Otherwise does nothing 
+    // where -- Name of the calling function 
 
+#ifdef SOLITAIRE_CHECK_HASH
+    std::uint64_t full=computeHash();
+    if (hash!=full){
+        std::fprintf(stderr,"Game::%s: incremental hash %016llx does not match recomputed %016llx\n",where,
+            static_cast<unsigned long long>(hash),static_cast<unsigned long long>(full));
+        std::abort();
     }
+#else
+    (void)where;
+#endif
+}
 
-};
+template<class Rules>
+void BasicGame<Rules>::updateWon(){
 
-// -- Applies Tableau to Tableau logic, cards can only move onto another if they are a different suit and one value lower 
-void Game::TableauToTableauLogic(const Move& move, const Card& movingCard,bool undo){ // Game Logic for a move to a Tableau pile 
+    // -- Check if they've won after applying a move 
 
-    // Moving card in this instance can be connected to other card
-     
-    // move -- Move object on which the logic is based on 
-    // movingCard -- The card object we want to move 
-    // undo -- Whether this is apart of an 'Undo' where the player has clicked the undo button 
-            
-    int cardValue=static_cast<int>(movingCard.getValue());
-    int suitValue=static_cast<int>(movingCard.getSuit()); 
+    bool hasWon=true;
+    for (int i=0;i<4;i++){
+        if (foundations[i].size()!=13) hasWon=false;
+    }
+    won=hasWon;
+}
 
-    if (undo){
+// ------ Rule checks 
 
-        // If it's an undo doesn't need to follow game logic
-        int endIndex=static_cast<int>(tableau[movingCard.getTableauPile()].size());
-        int indexsGoneThrough=1;
-        for (int c=movingCard.getTableauIndex();c<endIndex;c++){ // Go through moved card and connected cards, and pop back
-            pushToTableau(move,tableau[movingCard.getTableauPile()][c],tableau[movingCard.getTableauPile()]);
-            indexsGoneThrough++;
-        }
+namespace {
+
+// Whether two cards are the same playing card, ignoring where they are 
+bool sameCard(const Card& a, const Card& b){
+    return a.getSuit()==b.getSuit() && a.getValue()==b.getValue();
+}
+
+}
+
+template<class Rules>
+bool BasicGame<Rules>::canStackOnTableau(const Card& card,int pile) const{
+
+    // -- Cards can only move onto a Tableau pile if they are a different colour and one value lower, or onto an empty pile
+    // if Rules::emptyColumn allows, a King in Klondike. Both come from the Compatibility tables
+    // card -- The card we want to place
+    // pile -- The Tableau pile index
+
+    if (tableau[pile].empty()) return (Compatibility::emptyTableau<Rules>()>>cardIndex(card))&1;
+
+    const Card& endCard=tableau[pile].back();
+    return endCard.getFaceUp() && ((Compatibility::tables.tableau[cardIndex(endCard)]>>cardIndex(card))&1);
+}
 
-        // Set the card above the intended index to faceDown now, as this is what it would've been before the move 
-        tableau[move.getPile()][tableau[move.getPile()].size()-indexsGoneThrough].setFaceUp(false);
+template<class Rules>
+bool BasicGame<Rules>::canMoveToFoundation(const Card& card,int pile) const{
 
-        return;
+    // -- Cards can only move up to the foundation if they are the same suit and one value higher, or an Ace onto an empty pile
+    // card -- The card we want to place
+    // pile -- The foundation pile index
 
+    std::uint64_t accepts=foundations[pile].empty() ? Compatibility::tables.aces : Compatibility::tables.foundation[cardIndex(foundations[pile].back())];
+    return (accepts>>cardIndex(card))&1;
+}
+
+template<class Rules>
+bool BasicGame<Rules>::safeToFoundation(const Card& card) const{
+
+    // -- Whether moving card up to a foundation can never cost the game: Aces and Twos always, otherwise once both
+    // opposite colour cards one value lower are up, as nothing else could ever be placed on it
+    // card -- The card to move up 
+
+    int value=static_cast<int>(card.getValue());
+    if (value<=1) return true;
+
+    int color=static_cast<int>(card.getSuit())%2;
+    int lowerUp=0;
+    for (int f=0;f<4;f++){
+        if (foundations[f].empty() || static_cast<int>(foundations[f].back().getSuit())%2==color) continue;
+        if (static_cast<int>(foundations[f].back().getValue())>=value-1) lowerUp++;
     }
-    
-    int newIndex=-1;
-
-    if (!tableau[move.getPile()].empty()){
-       
-        Card &pileEndCard=tableau[move.getPile()].back();
-        int endCardValue=static_cast<int>(pileEndCard.getValue());
-        int cardSuit=static_cast<int>(pileEndCard.getSuit());
-        bool differentColors =(cardSuit%2)!=(suitValue%2);
-
-        if (endCardValue==cardValue+1 && differentColors){
-            int endIndex=static_cast<int>(tableau[movingCard.getTableauPile()].size());
-            newIndex=tableau[move.getPile()].size();
-            for (int c=movingCard.getTableauIndex();c<endIndex;c++){
-                // Go through moved card and connected cards, and pop back
-                pushToTableau(move,tableau[movingCard.getTableauPile()][c],tableau[movingCard.getTableauPile()]);
+    return lowerUp==2;
+}
+
+template<class Rules>
+bool BasicGame<Rules>::validMove(const Move& move) const{
+
+    // -- Returns whether a move is legal for Klondike, including that the move's card really is where the move says it is
+    // move -- The move to check 
+
+    const Card& card=move.getCard();
+    Location destination=move.getDestination();
+    int pile=move.getPile();
+    int startingPile=move.getStartingPile();
+
+    if (destination==Location::Tableau && (pile<0 || pile>=7)) return false;
+    if (destination==Location::Foundation && (pile<0 || pile>=4)) return false;
+
+    switch (move.getStartingPosition()){
+
+        case Location::Reserve: // Deal 
+            return destination==Location::Stockpile && !reserve.empty();
+
+        case Location::Stockpile: 
+            if (destination==Location::Reserve) return reserve.empty() && !stockpile.empty() && canRecycle(); // Recycle 
+            if (stockpile.empty() || !sameCard(stockpile.back(),card)) return false;
+            if (destination==Location::Foundation) return canMoveToFoundation(card,pile);
+            return destination==Location::Tableau && canStackOnTableau(card,pile);
+
+        case Location::Tableau: {
+            if (startingPile<0 || startingPile>=7) return false;
+            const std::vector<Card>& source=tableau[startingPile];
+            int index=card.getTableauIndex();
+            if (index<0 || index>=static_cast<int>(source.size())) return false;
+            if (!source[index].getFaceUp() || !sameCard(source[index],card)) return false;
+            if (destination==Location::Foundation){ // Only the last card of a pile can go up 
+                return index==static_cast<int>(source.size())-1 && canMoveToFoundation(card,pile);
             }
+            return destination==Location::Tableau && pile!=startingPile && canStackOnTableau(card,pile);
         }
 
-    } else if(cardValue==12) { // King move to an empty Tableau pile 
-        // Move card and all connected cards 
-        int endIndex=static_cast<int>(tableau[movingCard.getTableauPile()].size());
-        newIndex=tableau[move.getPile()].size();
-        for (int c=movingCard.getTableauIndex();c<endIndex;c++){ // Go through moved card and connected cards, and pop back
-            pushToTableau(move,tableau[movingCard.getTableauPile()][c],tableau[movingCard.getTableauPile()]);
-        }
+        case Location::Foundation:
+            if (startingPile<0 || startingPile>=4) return false;
+            if (foundations[startingPile].empty() || !sameCard(foundations[startingPile].back(),card)) return false;
+            return destination==Location::Tableau && canStackOnTableau(card,pile);
+
+        default:
+            return false;
     }
 
-    // Create a clone card with the new pile and index 
-    // so we can create a 'flipped' move in case the player Undoes.
-    Card clone=movingCard;
-    clone.setTableauPile(move.getPile());
-    clone.setTableauIndex(newIndex);
-    if (!undo) logMove(clone,move);
+}
 
-};
+// ------ Move generation
 
-void Game::applyMove(const Move& move,bool undo){ // Applies a move based on the logic of Klondike Solitaire 
+template<class Rules>
+int BasicGame<Rules>::generateMoves(MoveBuffer& moves) const{
 
-    // -- Applies a game move using the Move object 
-    // move - Move object on which the logic is based on 
-    // undo - Whether this is apart of an 'Undo' where the player has clicked the undo button 
-            
-    const Card& movingCard=move.getCard();
-    int cardValue=static_cast<int>(movingCard.getValue());
-    int suitValue=static_cast<int>(movingCard.getSuit()); // Red colour has property such that %2==1 
-    
-    if (move.getStartingPosition()==Location::Stockpile){  // We are moving a stockpile card
+    // -- Lists every legal move for the current position into moves, returns how many were written
+    // Never allocates, everything is built straight into the caller's buffer 
 
-        // In this case, we're either moving from the stockpiole to the Tableau or Foundation
+    int n=0;
 
-        if (move.getDestination()==Location::Foundation){ // We want to move from Stockpile to the Foundation
-            FoundationLogic(move,movingCard,stockpile,undo);
-        }
+    // What each pile accepts as a mask over card indexes ( see Compatibility in Rules.h ), worked out once so the checks
+    // below are a shift and an and. A pile with a face down top accepts nothing
+    std::uint64_t tableauAccepts[7];
+    for (int t=0;t<7;t++){
+        if (tableau[t].empty()) tableauAccepts[t]=Compatibility::emptyTableau<Rules>();
+        else if (tableau[t].back().getFaceUp()) tableauAccepts[t]=Compatibility::tables.tableau[cardIndex(tableau[t].back())];
+        else tableauAccepts[t]=0;
+    }
+    std::uint64_t foundationAccepts[4];
+    for (int f=0;f<4;f++){
+        foundationAccepts[f]=foundations[f].empty() ? Compatibility::tables.aces : Compatibility::tables.foundation[cardIndex(foundations[f].back())];
+    }
 
-        if (move.getDestination()==Location::Tableau){ // We want to move from Stockpile to a Tableau pile
-    
-            if (tableau[move.getPile()].empty() && cardValue==12){
-                // King move to an empty Tablau pile 
-                Card c=movingCard;
-                pushToTableau(move,c,stockpile);
-            }
+    auto fitsTableau=[&](const Card& c,int t){ return (tableauAccepts[t]>>cardIndex(c))&1; };
+    auto fitsFoundation=[&](const Card& c,int f){ return (foundationAccepts[f]>>cardIndex(c))&1; };
 
-            if (!tableau[move.getPile()].empty()){
+    // Stock actions, only one of these can ever apply
+    if (!reserve.empty()){
+        moves[n++]=Move(reserve.back(),Location::Reserve,Location::Stockpile,-1,-1);
+    } else if (!stockpile.empty() && canRecycle()){
+        moves[n++]=Move(stockpile.back(),Location::Stockpile,Location::Reserve,-1,-1);
+    }
 
-                Card endCard=tableau[move.getPile()].back();
-                int endCardValue=static_cast<int>(endCard.getValue());
-                bool differentColors =(static_cast<int>(endCard.getSuit())%2)!=(suitValue%2);
+    // Waste card to the foundations or Tableau 
+    if (!stockpile.empty()){
+        const Card& c=stockpile.back();
+        for (int f=0;f<4;f++){
+            if (fitsFoundation(c,f)) moves[n++]=Move(c,Location::Stockpile,Location::Foundation,f,-1);
+        }
+        for (int t=0;t<7;t++){
+            if (fitsTableau(c,t)) moves[n++]=Move(c,Location::Stockpile,Location::Tableau,t,-1);
+        }
+    }
 
-                if (differentColors && (endCardValue==cardValue+1)){
-                    Card c=movingCard;
-                    pushToTableau(move,c,stockpile);
-                }
+    for (int p=0;p<7;p++){
+        const std::vector<Card>& pile=tableau[p];
+        if (pile.empty()) continue;
 
-            }
+        // Last card up to the foundations 
+        for (int f=0;f<4;f++){
+            if (fitsFoundation(pile.back(),f)) moves[n++]=Move(pile.back(),Location::Tableau,Location::Foundation,f,p);
+        }
 
-            if (!undo){ // At this point the index would be size-1 
-                Card c=movingCard;
-                c.setTableauIndex(tableau[move.getPile()].size()-1);
-                c.setTableauPile(move.getPile());
-                c.setFoudationPile(-1);
-                logMove(c,move); // Log this move so it can be undone 
+        // Any face up card, and the run on top of it, onto another Tableau pile 
+        for (int i=static_cast<int>(pile.size())-1;i>=0 && pile[i].getFaceUp();i--){
+            for (int t=0;t<7;t++){
+                if (t!=p && fitsTableau(pile[i],t)) moves[n++]=Move(pile[i],Location::Tableau,Location::Tableau,t,p);
             }
-
         }
+    }
 
+    // Foundation cards back down to the Tableau 
+    for (int f=0;f<4;f++){
+        if (foundations[f].empty()) continue;
+        const Card& c=foundations[f].back();
+        for (int t=0;t<7;t++){
+            if (fitsTableau(c,t)) moves[n++]=Move(c,Location::Foundation,Location::Tableau,t,f);
+        }
     }
 
-    if (move.getStartingPosition()==Location::Tableau){ 
-        // We're moving from the Tableau to either Foundation or another Tableau pile 
+    return n;
 
-        if (move.getDestination()==Location::Foundation){ 
-            // We want to move from Tableau to the Foundation, so the dragged card must be the last card of the pile
-            int pileSize=static_cast<int>(tableau[movingCard.getTableauPile()].size());
-            if (pileSize==movingCard.getTableauIndex()+1){
-                // This is the last card, so we can apply Foundation logic 
-                FoundationLogic(move,movingCard,tableau[movingCard.getTableauPile()],undo);
-                tableau[movingCard.getTableauPile()].back().setFaceUp(true);
-            }
-        } 
+}
+
+// ------ Auto complete 
+
+template<class Rules>
+int BasicGame<Rules>::autoComplete(){
 
-        if (move.getDestination()==Location::Stockpile){ // This would occur during an Undo
-            pushToStockpile(movingCard,tableau[movingCard.getTableauPile()]);
+    // -- Moves every card that is safe to go up ( see safeToFoundation ) to the foundations, repeating as each move frees
+    // the next. Once nothing is hidden and the stock is empty every card is safe. Only piles whose top changed, or that
+    // were waiting on a foundation that has since grown, are looked at. The cascade is grouped with the move before it,
+    // so a single undo takes back both. Nothing moves while there are undone moves to redo, playing would forget them
+
+    if (canRedo()) return 0;
+    bool nothingHidden=reserve.empty() && stockpile.empty();
+    for (int i=0;i<7 && nothingHidden;i++){
+        if (!tableau[i].empty() && !tableau[i].front().getFaceUp()) nothingHidden=false; // Face down cards are at the bottom 
+    }
+    if (nothingHidden) dirtyPiles=0xFFFF;
+
+    const std::uint16_t sources=static_cast<std::uint16_t>(((1u<<7)-1)<<GameState::Tableau0 | 1u<<GameState::Stockpile);
+    int moved=0;
+    for (std::uint16_t pending=dirtyPiles&sources;pending!=0;pending=dirtyPiles&sources){
+        int id=0;
+        while (!(pending&(1u<<id))) id++;
+        dirtyPiles&=static_cast<std::uint16_t>(~(1u<<id));
+
+        const std::vector<Card>& source=pile(id);
+        if (source.empty()) continue;
+        const Card& top=source.back();
+        int suit=static_cast<int>(top.getSuit());
+        int value=static_cast<int>(top.getValue());
+
+        int target=-1;
+        for (int f=0;f<4 && target<0;f++){
+            if (canMoveToFoundation(top,f)) target=f;
         }
-        
-        if (move.getDestination()==Location::Tableau){
-            TableauToTableauLogic(move,movingCard,undo);
+        if (target>=0 && (nothingHidden || safeToFoundation(top))){
+            play(id,GameState::Foundation0+target,1,historyCursor>0); // Marks id dirty again for the card beneath 
+            moved++;
+            continue;
         }
 
+        // Not yet, note which foundations have to grow first so this pile is only looked at again once they have 
+        std::uint16_t bit=static_cast<std::uint16_t>(1u<<id);
+        if (target<0){
+            waitingOn[suit]|=bit;
+        } else {
+            for (int f=0;f<4;f++){
+                if (foundations[f].empty()) continue;
+                int other=static_cast<int>(foundations[f].back().getSuit());
+                if (other%2!=suit%2 && static_cast<int>(foundations[f].back().getValue())<value-1) waitingOn[other]|=bit;
+            }
+            for (int other=0;other<4;other++){ // An opposite colour with no foundation pile yet 
+                if (other%2==suit%2) continue;
+                bool started=false;
+                for (int f=0;f<4;f++) started|=!foundations[f].empty() && static_cast<int>(foundations[f].back().getSuit())==other;
+                if (!started) waitingOn[other]|=bit;
+            }
+        }
     }
+    return moved;
 
-    if (move.getStartingPosition()==Location::Foundation){ 
-        // Moving from foundation to a tableau pile 
-
-        Card endCard=tableau[move.getPile()].back();
-        int endCardSuit=static_cast<int>(endCard.getSuit());
-        int endCardValue=static_cast<int>(endCard.getValue());
-        bool differentColors =(endCardSuit%2)!=(suitValue%2);
-
-        if (move.getDestination()==Location::Stockpile){ // This would occur during an Undo
-            pushToStockpile(movingCard, foundations[movingCard.getFoundationPile()]);
-        } else if ( (differentColors && endCardValue==cardValue+1) || undo ){
-            // Valid move, push it to the tableau
-            Card c=movingCard; // Create clone 
-            pushToTableau(move,c,foundations[movingCard.getFoundationPile()]);
-           
-            if (undo){
-                // Make the index before the newly applied card now face down
-                int faceDownIndex=tableau[move.getPile()].size()-2;
-                tableau[move.getPile()][faceDownIndex].setFaceUp(false);
-            } else { 
-                // Log the move for future undos
-                c.setFoudationPile(-1);
-                c.setTableauIndex(tableau[move.getPile()].size()-1);
-                c.setTableauPile(move.getPile());
-                logMove(c,move);
-            }
+}
 
-        } 
+// ------ Logic functions 
 
+template<class Rules>
+bool BasicGame<Rules>::applyMove(const Move& move){ // Applies a move based on the logic of Klondike Solitaire 
+
+    // -- Applies a game move using the Move object, returns false and changes nothing if the move is illegal
+    // move - Move object on which the logic is based on 
+
+    if (!validMove(move)) return false;
+
+    Location start=move.getStartingPosition();
+    Location destination=move.getDestination();
+
+    if (start==Location::Reserve){ // Deal a card 
+        dealFromReserve();
+        return true;
+    }
+    if (start==Location::Stockpile && destination==Location::Reserve){ // Recycle 
+        resetStockpile();
+        return true;
     }
 
-    // Check if they've won after applying a move 
-    bool hasWon=true;
-    for (int i=0;i<4;i++){
-        if (foundations[i].size()!=13) hasWon=false;
+    int from=GameState::Stockpile;
+    int count=1;
+    if (start==Location::Tableau){
+        from=GameState::Tableau0+move.getStartingPile();
+        count=static_cast<int>(tableau[move.getStartingPile()].size())-move.getCard().getTableauIndex(); // The card and every card on top of it 
+    } else if (start==Location::Foundation){
+        from=GameState::Foundation0+move.getStartingPile();
     }
+    int to=(destination==Location::Tableau ? GameState::Tableau0 : GameState::Foundation0)+move.getPile();
 
-    won=hasWon;
+    play(from,to,count);
+    return true;
 
 }
 
-bool db{false};
+template<class Rules>
+void BasicGame<Rules>::undo(){
 
-void Game::undo(){
+    // -- Undoes the latest move, or group of moves such as an auto complete cascade 
 
-    // -- Undoes the latest move in moveHistory
-    
-    if (moveHistory.empty() || db ) return; 
-    db=true;
+    while (historyCursor>0){
+        bool grouped=Delta::grouped(history[historyCursor-1]);
+        undoOne();
+        if (!grouped) break;
+    }
+
+}
+
+template<class Rules>
+void BasicGame<Rules>::redo(){
+
+    // -- Makes the latest undone move, or group of moves, again 
 
-    std::cout << "Performing an Undo " << std::endl;
+    if (historyCursor==history.size()) return;
+    redoOne();
+    while (historyCursor<history.size() && Delta::grouped(history[historyCursor])) redoOne();
+
+}
+
+template<class Rules>
+void BasicGame<Rules>::undoOne(){
+
+    // -- Undoes the latest history entry, by putting back exactly what it says changed 
     
-    Move &lastMove=moveHistory.back();
-
-    Location startingPosition=lastMove.getStartingPosition();
-    Location destination=lastMove.getDestination();
-    int startingPile=lastMove.getStartingPile();
-
-    std::cout<<"Destination : " << static_cast<int>(destination) << std::endl;
-    std::cout<<"StartingPosition : " << static_cast<int>(startingPosition) << std::endl;
-    std::cout<<"destination Pile : " << static_cast<int>(startingPile) << std::endl;
-
-    Move undoMove( // Essentialy create a 'flipped' move of the last move 
-        lastMove.getCard(),
-        destination,
-        startingPosition,
-        startingPile,
-        -1
-    );
-
-    if (startingPosition==Location::Reserve) {
-        // Bring the dealt card back to the reseve 
-        Card card=stockpile.back();
-        reserve.push_back(card);
-        stockpile.pop_back();
-    } else { 
-        applyMove(undoMove,true);
-    }
+    if (historyCursor==0) return; 
+
+    std::uint16_t delta=history[--historyCursor];
+    int from=Delta::from(delta);
+    if (Delta::revealed(delta)) turnTop(from,false); // Turn the uncovered card back over 
+    transfer(Delta::to(delta),from,Delta::count(delta));
+    account(delta,-1);
+    updateWon();
+    revision++;
+    checkHash("undo");
+
+}
+
+template<class Rules>
+void BasicGame<Rules>::redoOne(){
+
+    // -- Makes the latest undone history entry again 
+
+    if (historyCursor==history.size()) return;
+
+    std::uint16_t delta=history[historyCursor++];
+    int from=Delta::from(delta);
+    transfer(from,Delta::to(delta),Delta::count(delta));
+    if (Delta::revealed(delta)) turnTop(from,true);
+    account(delta,1);
+    updateWon();
+    revision++;
+    checkHash("redo");
+
+}
 
-    moveHistory.pop_back();
-    db=false;
+// ------ Variants, every rules policy used anywhere is built here once 
 
-}
\ No newline at end of file
+template class BasicGame<KlondikeRules>;
+template class BasicGame<DrawThreeRules>;
+template class BasicGame<VegasRules>;
+template class BasicGame<RelaxedRules>;
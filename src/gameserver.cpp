@@ -0,0 +1,390 @@
+// gameserver.cpp
+// Socket loop and request handling of GameServer, and GameClient, see GameServer.h and Protocol.h
+
+#include "GameServer.h"
+#include "Notation.h"
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int sendFlags=MSG_NOSIGNAL; // A peer hanging up is an error return, not a SIGPIPE
+#else
+constexpr int sendFlags=0;
+#endif
+
+constexpr std::size_t readChunk=64*1024;
+constexpr std::size_t maxPendingOut=1<<20; // Stop reading from a client that isn't reading its answers
+
+void append(std::vector<unsigned char>& out,const void* data,std::size_t size){
+    const unsigned char* bytes=static_cast<const unsigned char*>(data);
+    out.insert(out.end(),bytes,bytes+size);
+}
+
+#ifndef _WIN32
+
+// -- Where send has no MSG_NOSIGNAL ( macOS ) the socket itself is told not to raise SIGPIPE
+void noSigpipe(int fd){
+#ifdef SO_NOSIGPIPE
+    int on=1;
+    setsockopt(fd,SOL_SOCKET,SO_NOSIGPIPE,&on,sizeof(on));
+#else
+    (void)fd;
+#endif
+}
+
+// -- Splits "host:port" or ":port", false if address isn't one and so names a Unix socket
+bool tcpAddress(const std::string& address,std::string& host,std::string& port){
+    std::size_t colon=address.rfind(':');
+    if (colon==std::string::npos || colon+1==address.size()) return false;
+    for (std::size_t i=colon+1;i<address.size();i++){
+        if (address[i]<'0' || address[i]>'9') return false;
+    }
+    host=address.substr(0,colon);
+    port=address.substr(colon+1);
+    return true;
+}
+
+// -- Opens a socket for address and binds ( listening ) or connects it, -1 on failure with why set
+int openSocket(const std::string& address,bool listening,std::string& why){
+
+    std::string host,port;
+    if (tcpAddress(address,host,port)){
+        addrinfo hints{};
+        hints.ai_family=AF_UNSPEC;
+        hints.ai_socktype=SOCK_STREAM;
+        hints.ai_flags=listening ? AI_PASSIVE : 0;
+        addrinfo* found=nullptr;
+        int failed=getaddrinfo(host.empty() ? nullptr : host.c_str(),port.c_str(),&hints,&found);
+        if (failed!=0){
+            why=gai_strerror(failed);
+            return -1;
+        }
+        int fd=-1;
+        for (addrinfo* a=found;a;a=a->ai_next){
+            fd=::socket(a->ai_family,a->ai_socktype,a->ai_protocol);
+            if (fd<0) continue;
+            noSigpipe(fd);
+            int on=1;
+            if (listening) setsockopt(fd,SOL_SOCKET,SO_REUSEADDR,&on,sizeof(on));
+            setsockopt(fd,IPPROTO_TCP,TCP_NODELAY,&on,sizeof(on)); // Requests are tiny, don't hold them back
+            if ((listening ? ::bind(fd,a->ai_addr,a->ai_addrlen) : ::connect(fd,a->ai_addr,a->ai_addrlen))==0) break;
+            ::close(fd);
+            fd=-1;
+        }
+        if (fd<0) why=std::strerror(errno);
+        freeaddrinfo(found);
+        return fd;
+    }
+
+    sockaddr_un local{};
+    if (address.empty() || address.size()>=sizeof(local.sun_path)){
+        why="socket path is empty or too long";
+        return -1;
+    }
+    local.sun_family=AF_UNIX;
+    std::memcpy(local.sun_path,address.c_str(),address.size()+1);
+    int fd=::socket(AF_UNIX,SOCK_STREAM,0);
+    if (fd<0){
+        why=std::strerror(errno);
+        return -1;
+    }
+    noSigpipe(fd);
+    if (listening) ::unlink(address.c_str()); // A stale socket from an earlier run
+    if ((listening ? ::bind(fd,reinterpret_cast<sockaddr*>(&local),sizeof(local)) : ::connect(fd,reinterpret_cast<sockaddr*>(&local),sizeof(local)))!=0){
+        why=std::strerror(errno);
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+
+}
+
+#endif
+
+}
+
+// ------ Request handling
+
+GameServer::GameServer(std::uint32_t maxSessions) : pool(maxSessions), readBuffer(readChunk+sizeof(Request)) {}
+
+void GameServer::handle(const Request& request,std::vector<unsigned char>& out){
+
+    // request -- One request as it came off the wire, nothing in it is trusted
+    // out -- Where the response goes
+
+    requests++;
+    Response response;
+    response.status=Status::Ok;
+    response.op=request.op;
+    response.session=request.session;
+
+    if (request.op==Op::Stats){
+        ServerStats payload=stats();
+        response.payloadBytes=sizeof(payload);
+        append(out,&response,sizeof(response));
+        append(out,&payload,sizeof(payload));
+        return;
+    }
+    if (request.op==Op::Open){
+        response.session=pool.open(request.seed);
+        if (response.session==0) response.status=Status::Full;
+        else response.hash=pool.find(response.session)->getHash();
+        append(out,&response,sizeof(response));
+        return;
+    }
+
+    Game* game=pool.find(request.session);
+    if (!game){
+        response.status=Status::NoSession;
+        append(out,&response,sizeof(response));
+        return;
+    }
+
+    switch (request.op){
+        case Op::Close:
+            pool.close(request.session);
+            game=nullptr;
+            break;
+        case Op::Deal:
+            game->dealNewGame(request.seed);
+            break;
+        case Op::Move:{
+            Move move;
+            if (!pileMove(*game,request.from,request.to,request.index,move) || !game->applyMove(move)) response.status=Status::Illegal;
+            break;
+        }
+        case Op::Undo:
+            game->undo();
+            break;
+        case Op::Redo:
+            game->redo();
+            break;
+        case Op::State:
+            response.payloadBytes=sizeof(GameState);
+            break;
+        default:
+            response.status=Status::BadRequest;
+    }
+
+    if (game) response.hash=game->getHash();
+    append(out,&response,sizeof(response));
+    if (request.op==Op::State){
+        GameState state=game->getState();
+        append(out,&state,sizeof(state));
+    }
+
+}
+
+ServerStats GameServer::stats() const{
+    ServerStats s{};
+    s.sessions=pool.live();
+    s.slots=pool.slots();
+    s.poolBytes=pool.bytes();
+    s.requests=requests;
+    s.connections=static_cast<std::uint32_t>(connections.size());
+    return s;
+}
+
+#ifdef _WIN32
+
+GameServer::~GameServer() {}
+
+bool GameServer::listen(const std::string&){
+    lastError="the game server needs POSIX sockets";
+    return false;
+}
+
+void GameServer::run() {}
+
+bool GameServer::serve(Connection&) { return false; }
+bool GameServer::flush(Connection&) { return false; }
+
+GameClient::~GameClient() {}
+bool GameClient::connect(const std::string&) { return false; }
+bool GameClient::send(const Request*,std::size_t) { return false; }
+bool GameClient::readFully(void*,std::size_t) { return false; }
+
+#else
+
+// ------ Socket loop
+
+GameServer::~GameServer(){
+    for (Connection& c : connections) ::close(c.socket);
+    if (listener>=0) ::close(listener);
+    if (!unixPath.empty()) ::unlink(unixPath.c_str());
+}
+
+bool GameServer::listen(const std::string& address){
+
+    // address -- "host:port", ":port" or a Unix socket path
+
+    std::string host,port;
+    listener=openSocket(address,true,lastError);
+    if (listener<0) return false;
+    if (!tcpAddress(address,host,port)) unixPath=address;
+    if (::listen(listener,SOMAXCONN)!=0){
+        lastError=std::strerror(errno);
+        return false;
+    }
+    fcntl(listener,F_SETFL,fcntl(listener,F_GETFL)|O_NONBLOCK);
+    return true;
+
+}
+
+void GameServer::run(){
+
+    // -- Polls the listener and every connection, answering whole requests as they arrive. Replies go out in the
+    // order their requests came in, a connection that stops reading them stops being read from
+
+    std::vector<pollfd> polled;
+    while (!stopping.load()){
+        polled.clear();
+        polled.push_back({listener,POLLIN,0});
+        for (const Connection& c : connections){
+            short events=c.out.size()-c.sent<maxPendingOut ? POLLIN : 0;
+            if (c.sent<c.out.size()) events|=POLLOUT;
+            polled.push_back({c.socket,events,0});
+        }
+        if (::poll(polled.data(),polled.size(),100)<=0) continue;
+
+        // Index 0 is the listener, connection i is polled[i+1]. Closed connections are swapped out from the back, so
+        // walk backwards to keep the two in step
+        for (std::size_t i=connections.size();i-->0;){
+            short ready=polled[i+1].revents;
+            if (!ready) continue;
+            bool open=true;
+            if (ready&(POLLIN|POLLHUP|POLLERR)) open=serve(connections[i]);
+            if (open && (ready&POLLOUT)) open=flush(connections[i]);
+            if (!open){
+                ::close(connections[i].socket);
+                connections[i]=std::move(connections.back());
+                connections.pop_back();
+            }
+        }
+
+        if (polled[0].revents&POLLIN){
+            int fd;
+            while ((fd=::accept(listener,nullptr,nullptr))>=0){
+                fcntl(fd,F_SETFL,fcntl(fd,F_GETFL)|O_NONBLOCK);
+                noSigpipe(fd);
+                int on=1;
+                setsockopt(fd,IPPROTO_TCP,TCP_NODELAY,&on,sizeof(on)); // Fails harmlessly on a Unix socket
+                connections.push_back({fd,{},{},0});
+            }
+        }
+    }
+
+}
+
+bool GameServer::serve(Connection& connection){
+
+    // -- Reads whatever has arrived, answers every complete request in it and sends the answers
+
+    // The leftover of a part sent request goes first, then as much as the socket has 
+    std::vector<unsigned char>& in=connection.in;
+    std::memcpy(readBuffer.data(),in.data(),in.size());
+    ssize_t got=::recv(connection.socket,readBuffer.data()+in.size(),readChunk,0);
+    if (got<=0) return got<0 && (errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR);
+    std::size_t size=in.size()+static_cast<std::size_t>(got);
+
+    if (connection.sent==connection.out.size()){ // Everything sent, start the buffer over
+        connection.out.clear();
+        connection.sent=0;
+    }
+    std::size_t used=0;
+    for (;used+sizeof(Request)<=size;used+=sizeof(Request)){
+        Request request;
+        std::memcpy(&request,readBuffer.data()+used,sizeof(request));
+        handle(request,connection.out);
+    }
+    in.assign(readBuffer.begin()+used,readBuffer.begin()+size); // At most part of one request is left
+    return flush(connection);
+
+}
+
+bool GameServer::flush(Connection& connection){
+
+    while (connection.sent<connection.out.size()){
+        ssize_t put=::send(connection.socket,connection.out.data()+connection.sent,connection.out.size()-connection.sent,sendFlags);
+        if (put<0) return errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR; // Full, poll says when to carry on
+        connection.sent+=static_cast<std::size_t>(put);
+    }
+    return true;
+
+}
+
+// ------ Client
+
+GameClient::~GameClient(){
+    if (socket>=0) ::close(socket);
+}
+
+bool GameClient::connect(const std::string& address){
+    std::string why;
+    if (socket>=0) ::close(socket);
+    socket=openSocket(address,false,why);
+    return socket>=0;
+}
+
+bool GameClient::send(const Request* requests,std::size_t count){
+    const unsigned char* data=reinterpret_cast<const unsigned char*>(requests);
+    std::size_t size=count*sizeof(Request);
+    while (size>0){
+        ssize_t put=::send(socket,data,size,sendFlags);
+        if (put<0 && errno==EINTR) continue;
+        if (put<=0) return false;
+        data+=put;
+        size-=static_cast<std::size_t>(put);
+    }
+    return true;
+}
+
+bool GameClient::readFully(void* data,std::size_t size){
+    unsigned char* bytes=static_cast<unsigned char*>(data);
+    while (size>0){
+        ssize_t got=::recv(socket,bytes,size,0);
+        if (got<0 && errno==EINTR) continue;
+        if (got<=0) return false;
+        bytes+=got;
+        size-=static_cast<std::size_t>(got);
+    }
+    return true;
+}
+
+#endif
+
+bool GameClient::receive(Response& response,void* payload,std::size_t payloadSize){
+
+    // payload -- Where the response's payload goes, if it has one
+    // payloadSize -- Room at payload
+
+    if (!readFully(&response,sizeof(response))) return false;
+    std::size_t kept=std::min<std::size_t>(response.payloadBytes,payload ? payloadSize : 0);
+    if (kept>0 && !readFully(payload,kept)) return false;
+    unsigned char skip[256];
+    for (std::size_t left=response.payloadBytes-kept;left>0;){
+        std::size_t n=std::min(left,sizeof(skip));
+        if (!readFully(skip,n)) return false;
+        left-=n;
+    }
+    return true;
+
+}
+
+bool GameClient::call(const Request& request,Response& response,void* payload,std::size_t payloadSize){
+    return send(&request,1) && receive(response,payload,payloadSize);
+}
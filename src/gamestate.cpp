@@ -0,0 +1,49 @@
+// gamestate.cpp
+// Deals new games straight into a GameState, see GameState.h
+
+#include "GameState.h"
+#include "Random.h"
+#include <utility>
+
+GameState GameState::dealt(std::uint64_t dealNumber){
+
+    // dealNumber -- Which deal, the same number always gives the same deal 
+
+    std::uint8_t deck[52];
+    for (int i=0;i<52;i++) deck[i]=static_cast<std::uint8_t>((i/13)<<suitShift | (i%13));
+
+    Xoshiro256 rng(dealNumber);
+    for (int i=51;i>0;i--) std::swap(deck[i],deck[rng.below(static_cast<std::uint32_t>(i+1))]);
+
+    GameState state{};
+    int next=51; // Deal from the end of the deck 
+    int n=24; // Tableau cards go after the 24 reserve cards 
+    for (int p=0;p<7;p++){
+        for (int c=0;c<=p;c++) state.cards[n++]=deck[next--] | (c==p ? faceUpBit : 0);
+        state.pileEnd[Tableau0+p]=static_cast<std::uint8_t>(n);
+    }
+    for (int i=0;i<24;i++) state.cards[i]=deck[i]; // What's left, deck[23] is on top 
+    state.pileEnd[Reserve]=24;
+    state.pileEnd[Stockpile]=24;
+    for (int f=0;f<4;f++) state.pileEnd[Foundation0+f]=static_cast<std::uint8_t>(n);
+    return state;
+
+}
+
+bool GameState::valid() const{
+
+    // -- Only checks what a Game needs to load it safely, not that the position could come up in play 
+
+    bool seen[64]={};
+    for (std::uint8_t packed : cards){
+        int card=packed&~faceUpBit;
+        if (packed&0x80 || (packed&valueMask)>12 || seen[card]) return false;
+        seen[card]=true;
+    }
+    int end=0;
+    for (std::uint8_t pileEndAt : pileEnd){
+        if (pileEndAt<end || pileEndAt-end>24) return false; // No pile ever holds more than the 24 reserve cards 
+        end=pileEndAt;
+    }
+    return end==52 && won<=1;
+}
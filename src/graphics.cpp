@@ -6,158 +6,179 @@
 #include "Input.h"
 #include <iostream>
 
-//    --- Stockpile rendering
-void SolitaireGraphics::drawStockpile(sf::RenderWindow& window,const Game& game) const {
-                         
-    // window -- The Solitaire window object 
+// -- Queues one Spritesheet frame, the size of a card, at position 
+void SolitaireGraphics::addCard(QuadBatch& batch, int frame, sf::Vector2f position) const {
+
+    // batch -- Where to queue it 
+    // frame -- Spritesheet frame number, i.e. Spritesheet::cardFrame 
+    // position -- Top left corner on the window 
+
+    batch.add({ position, { static_cast<float>(sheet.cardWidth()), static_cast<float>(sheet.cardHeight()) } },sheet.frameRect(frame));
+}
+
+//    --- Reserve rendering, the back card to deal from or the reset card 
+void SolitaireGraphics::drawReserve(const Game& game) const {
+
     // game -- The solitaire game instance storing all game data
-    
+
+    QuadBatch& batch=pileCards[GameState::Reserve];
+    batch.clear();
     if (game.getReserve().empty()){ // All cards have been dealt, so show the reset card
-        auto sprite = sheet.makeResetSprite(); 
-        sprite.setPosition({ stockpileXOffset, foundationYOffset });
-        window.draw(sprite);
+        addCard(batch,Spritesheet::resetFrame,{ stockpileXOffset, foundationYOffset });
     } else { // Not all card's have been dealt, so show the back card
-        auto sprite = sheet.makeBackSprite(); 
-        sprite.setPosition({ stockpileXOffset, foundationYOffset });
-        window.draw(sprite);
+        addCard(batch,builtBackFrame,{ stockpileXOffset, foundationYOffset });
     }
+}
+
+//    --- Stockpile rendering
+void SolitaireGraphics::drawStockpile(const Game& game) const {
+                         
+    // game -- The solitaire game instance storing all game data
+    
+    QuadBatch& batch=pileCards[GameState::Stockpile];
+    batch.clear();
 
     // Render the topmost card in the stockpile/dealing area, excluding dragged ones ( Handled in seperate function drawDragged)
     if (!game.getStockpile().empty()) {
         const Card& c = game.getStockpile().back();
-        if (draggedCard!=nullptr){
-            if (draggedCard==&c) return; // This card is being dragged, hence we don't want to render it 
-        }
-        auto sprite = sheet.makeCardSprite(c);
-        sprite.setPosition({ stockpileXOffset+pileSpacing, foundationYOffset });
-        window.draw(sprite);
+        if (draggedCard==&c) return; // This card is being dragged, hence we don't want to render it 
+        addCard(batch,Spritesheet::cardFrame(c),{ stockpileXOffset+pileSpacing, foundationYOffset });
     } 
 }
 
-//    --- Foundation pile rendering
-void SolitaireGraphics::drawFoundations(sf::RenderWindow& window,const Game& game) const {
+//    --- Foundation pile rendering, one pile 
+void SolitaireGraphics::drawFoundation(int i, const Game& game) const {
 
-    // window - The Solitaire window object 
+    // i - Foundation pile 
     // game - The solitaire game instance storing all game data
 
-    float cardWidth = static_cast<float>(sheet.cardWidth());
-    float cardHeight= static_cast<float>(sheet.cardHeight());
+    QuadBatch& batch=pileCards[GameState::Foundation0+i];
+    batch.clear();
+    const std::vector<Card>& pile=game.getFoundation(i);
+    if (pile.empty()) return; // Shown by its outline in slots 
 
-    float xStart = stockpileXOffset + 3.0f * pileSpacing;
-    float y = foundationYOffset;
-
-    for (int i = 0; i < 4; ++i) { // Iterate through the foundation piles 
-        float x = xStart+i*pileSpacing;
-        if (game.getFoundation(i).empty()) { // The foundation pile is empty
-            sf::RectangleShape rect;
-            rect.setSize({ cardWidth, cardHeight });
-            rect.setPosition({ x, y });
-            rect.setFillColor(sf::Color::Transparent);
-            rect.setOutlineColor(sf::Color(200, 200, 200));
-            rect.setOutlineThickness(2.f);
-            window.draw(rect); // If the foundation pile is empty draw the default rectangle to indicate an empty pile
-        } else { // The foundation pile isn't empty, so render the top-most foundation card, or if the current card is being dragged show the card behind it
-            
-            int index=1;
-            const Card& card=game.getFoundation(i).back();
-           
-            if (&card==draggedCard) {
-                index=2; // Get the card behind the dragged card 
-            }
-
-            int pileSize=static_cast<int>(game.getFoundation(i).size());
-
-            if (index<=pileSize){ // Ensure that the index is appropriate such that we avoid a heap issue 
-                const Card& c=game.getFoundation(i)[game.getFoundation(i).size()-index];
-                auto sprite = sheet.makeCardSprite(c);
-                sprite.setPosition({ x, y });
-                window.draw(sprite);  // Draw out foundation card 
-            }
-
-        }
+    // Render the top-most foundation card, or if the current card is being dragged show the card behind it
+    std::size_t index=&pile.back()==draggedCard ? 2 : 1; // Skip the dragged card 
+    if (index<=pile.size()){ // Ensure that the index is appropriate such that we avoid a heap issue 
+        float x = stockpileXOffset + 3.0f * pileSpacing + i*pileSpacing;
+        addCard(batch,Spritesheet::cardFrame(pile[pile.size()-index]),{ x, foundationYOffset }); // Draw out foundation card 
     }
 
 }
 
-//    --- Tableau rendering 
-void SolitaireGraphics::drawTableau(sf::RenderWindow& window) const {
+//    --- Tableau rendering, one pile 
+void SolitaireGraphics::drawTableau(int i) const {
 
-    // window - The Solitaire window object 
-    // game - The solitaire game instance storing all game data
+    // i - Tableau pile 
+
+    QuadBatch& batch=pileCards[GameState::Tableau0+i];
+    batch.clear();
+    const std::vector<Card>& pile=game.getTableau(i);
+    int pileSize=static_cast<int>(pile.size());
+    for (int k=0;k<pileSize;k++){ // Iterate through each card 
+        const Card& c = pile[k]; 
+        sf::Vector2f position{ stockpileXOffset+(pileSpacing*i), tableauYOffset+(k*tableauYSpacing) };
+        if (c.getFaceUp()){ // Card is face up, so we should show it 
 
-    for (int i=0;i<7;i++){ // Iterate through each Tableau pile 
-        std::vector<Card> cards=game.getTableau(i);
-        int pileSize=static_cast<int>(cards.size());
-        for (int k=0;k<pileSize;k++){ // Iterate through each card 
-            const Card& c = game.getTableau(i)[k]; 
-            if (c.getFaceUp()){ // Card is face up, so we should show it 
-                auto sprite = sheet.makeCardSprite(c);
-                sprite.setPosition({ stockpileXOffset+(pileSpacing*i), tableauYOffset+(k*tableauYSpacing)} );
-
-                if (draggedCard!=nullptr){ // Before we draw this card out, we need to ensure it isn't being dragged alongside the dragged card 
-                    if (draggedCard->getLocation()==Location::Tableau){
-                        if (draggedCard->getTableauPile() == c.getTableauPile() && draggedCard->getTableauIndex()<=c.getTableauIndex()){
-                            continue; // This is a connected card to the currently dragged card, so it will be rendered in the drawDragging function instead
-                        }
+            if (draggedCard!=nullptr){ // Before we draw this card out, we need to ensure it isn't being dragged alongside the dragged card 
+                if (draggedCard->getLocation()==Location::Tableau){
+                    if (draggedCard->getTableauPile() == c.getTableauPile() && draggedCard->getTableauIndex()<=c.getTableauIndex()){
+                        continue; // This is a connected card to the currently dragged card, so it will be rendered in the drawDragging function instead
                     }
                 }
-
-                window.draw(sprite); // Not connected to the dragged card, we're free to render it 
-
-            } else { // Card isn't face up, show back card instead 
-                auto sprite = sheet.makeBackSprite();
-                sprite.setPosition({ stockpileXOffset+(pileSpacing*i), tableauYOffset+(k*tableauYSpacing)} );
-                window.draw(sprite);
             }
 
+            addCard(batch,Spritesheet::cardFrame(c),position); // Not connected to the dragged card, we're free to render it 
+
+        } else { // Card isn't face up, show back card instead 
+            addCard(batch,builtBackFrame,position);
         }
+
     }
   
 }
 
-//    --- Dragged cards rendering 
-void SolitaireGraphics::drawDragging(sf::RenderWindow& window) const { 
+//    --- Dragged cards rendering, drawn after the scene so they sit on top of everything 
+void SolitaireGraphics::drawDragging() const { 
 
-    // window - The Solitaire window object 
-    // game - The solitaire game instance storing all game data
+    dragged.clear();
+    if (draggedCard==nullptr) return; // Nothing is being dragged 
 
-    sf::Vector2f mouse = window.mapPixelToCoords(sf::Mouse::getPosition(window));
-
-    if (draggedCard!=nullptr){ // Check if there is a currently dragged card 
-
-        Card draggedCardObj=*draggedCard;
-        auto sprite = sheet.makeCardSprite(draggedCardObj);
-        sprite.setPosition({ mouse.x+mouseXOffset,mouse.y+mouseYOffset } ); // Set the dragged card to the mouse 
- 
-        if (draggedCardObj.getLocation()==Location::Tableau){ // Check if any other cards are being dragged alongside this card, only applicable to Tableau cards
-           
-            // Go through cards ahead of this card in the tableau pile 
-            int pile=draggedCardObj.getTableauPile();
-            int i=1;
-            int pileSize=static_cast<int>(game.getTableau(pile).size());
-            for (int c=draggedCardObj.getTableauIndex();c<pileSize;c++){ // These cards are ahead of the dragged card ( Further down the Tableau ), so connected
-                Card connectedCard=game.getTableau(pile)[c];
-                auto sprite = sheet.makeCardSprite(connectedCard);
-                sprite.setPosition({ mouse.x+mouseXOffset,mouse.y+mouseYOffset+(tableauYSpacing*i)} );
-                window.draw(sprite); // Draw each connected card, inclusive of the sole dragged card 
-                i++;
-            }
-        
-        } else { 
-            window.draw(sprite); // No connected cards so just draw the sole dragged card 
+    if (draggedCard->getLocation()==Location::Tableau){ // Check if any other cards are being dragged alongside this card, only applicable to Tableau cards
+       
+        // The dragged card and every card ahead of it in the Tableau pile ( Further down the Tableau ), so connected
+        const std::vector<Card>& pile=game.getTableau(draggedCard->getTableauPile());
+        int i=1;
+        for (std::size_t c=draggedCard->getTableauIndex();c<pile.size();c++){
+            addCard(dragged,Spritesheet::cardFrame(pile[c]),{ mouse.x+mouseXOffset,mouse.y+mouseYOffset+(tableauYSpacing*i)} );
+            i++;
         }
+    
+    } else { 
+        addCard(dragged,Spritesheet::cardFrame(*draggedCard),{ mouse.x+mouseXOffset,mouse.y+mouseYOffset }); // No connected cards so just draw the sole dragged card 
+    }
 
+}
+
+// -- Brings the retained scene up to date, laying out again only the piles that changed since the last frame 
+void SolitaireGraphics::updateScene(const Game& game) const {
+
+    // game - The solitaire game instance storing all game data
+
+    constexpr std::uint32_t everyPile=(1u<<GameState::PileCount)-1;
+    constexpr std::uint32_t backsShown=(1u<<GameState::Reserve) | (((1u<<7)-1)<<GameState::Tableau0); // Piles that can show a face down card 
+
+    std::uint32_t dirty=0;
+    if (!sceneBuilt || draggedCard!=builtDragged) dirty=everyPile; // Picking up or dropping cards changes what their pile shows 
+    int back=sheet.backFrame();
+    if (back!=builtBackFrame) dirty|=backsShown; // The back animation moved on 
+    for (int id=0;id<GameState::PileCount;id++){
+        if (game.getPileRevision(id)!=builtRevisions[id]) dirty|=1u<<id;
+    }
+
+    pilesRebuilt=0;
+    if (dirty==0) return; // Nothing changed, the scene from last frame stands 
+
+    builtBackFrame=back;
+    builtDragged=draggedCard;
+    sceneBuilt=true;
+    for (int id=0;id<GameState::PileCount;id++){
+        if (!(dirty & (1u<<id))) continue;
+        if (id==GameState::Reserve) drawReserve(game);
+        else if (id==GameState::Stockpile) drawStockpile(game);
+        else if (id<GameState::Foundation0) drawTableau(id-GameState::Tableau0);
+        else drawFoundation(id-GameState::Foundation0,game);
+        builtRevisions[id]=game.getPileRevision(id);
+        pilesRebuilt++;
+    }
+
+    // Empty foundations are outlined instead 
+    if (dirty & (0xFu<<GameState::Foundation0)){
+        slots.clear();
+        float cardWidth = static_cast<float>(sheet.cardWidth());
+        float cardHeight= static_cast<float>(sheet.cardHeight());
+        for (int i=0;i<4;i++){
+            if (!game.getFoundation(i).empty()) continue;
+            float x = stockpileXOffset + 3.0f * pileSpacing + i*pileSpacing;
+            slots.addOutline({ { x, foundationYOffset }, { cardWidth, cardHeight } },2.f,sf::Color(200, 200, 200),sheet.solidTexel());
+        }
     }
 
+    // Join the piles in the order they were always drawn, foundations, Tableau then the stock 
+    scene.clear();
+    for (int i=0;i<4;i++) scene.append(pileCards[GameState::Foundation0+i]);
+    for (int i=0;i<7;i++) scene.append(pileCards[GameState::Tableau0+i]);
+    scene.append(pileCards[GameState::Reserve]);
+    scene.append(pileCards[GameState::Stockpile]);
+
 }
 
 // -- Draw the undo button
-void SolitaireGraphics::drawUndo(sf::RenderWindow& window) const { 
+void SolitaireGraphics::drawUndo(sf::RenderTarget& window) const { 
 
     // window - The Solitaire window object 
 
-    sf::Texture undo=sheet.getUndo(); // Get texture 
-    sf::Sprite undoButton{undo}; // Set texture to sprite 
+    sf::Sprite undoButton{sheet.getUndo(),sheet.getUndoRect()}; // Set texture to sprite, Resources owns it 
     undoButton.setPosition({ // Position undo button
         undoXOffset,undoYOffset
     });
@@ -166,31 +187,99 @@ void SolitaireGraphics::drawUndo(sf::RenderWindow& window) const {
 
 
 // -- Draw the new deal butotn 
-void SolitaireGraphics::drawNewDeal(sf::RenderWindow& window) const{ 
+void SolitaireGraphics::drawNewDeal(sf::RenderTarget& window) const{ 
 
     // window - The Solitaire window object 
 
-    sf::Texture newDeal=sheet.getNewDeal(); // Get texture 
-    sf::Sprite newDealButton{newDeal}; // Set texture to sprite 
+    sf::Sprite newDealButton{sheet.getNewDeal(),sheet.getNewDealRect()}; // Set texture to sprite, Resources owns it 
     newDealButton.setPosition({ // Position the new deal button 
         newDealXOffset,newDealYOffset
     });
     window.draw(newDealButton); // Draw the new deal button 
 }
 
+// -- Queues both buttons, for when they are on the same texture as the cards 
+void SolitaireGraphics::addButtons(QuadBatch& batch) const {
+
+    // batch -- Where to queue them 
+
+    batch.add({ { undoXOffset, undoYOffset }, sf::Vector2f(sheet.getUndoRect().size) },sheet.getUndoRect());
+    batch.add({ { newDealXOffset, newDealYOffset }, sf::Vector2f(sheet.getNewDealRect().size) },sheet.getNewDealRect());
+}
+
+// -- Outline the suggested move, the card to move and where to drop it 
+void SolitaireGraphics::drawHint() const {
+
+    if (!hint) return;
+
+    float cardWidth = static_cast<float>(sheet.cardWidth());
+    float cardHeight= static_cast<float>(sheet.cardHeight());
+
+    auto outline=[&](sf::Vector2f position){
+        overlay.addOutline({ position, { cardWidth, cardHeight } },3.f,sf::Color(255, 220, 0),sheet.solidTexel());
+    };
+
+    const Move& move=*hint;
+    float foundationX = stockpileXOffset + 3.0f * pileSpacing;
+
+    // The card to move 
+    switch (move.getStartingPosition()){
+        case Location::Reserve: outline({ stockpileXOffset, foundationYOffset }); return; // Deal 
+        case Location::Stockpile:
+            if (move.getDestination()==Location::Reserve){ // Recycle 
+                outline({ stockpileXOffset, foundationYOffset });
+                return;
+            }
+            outline({ stockpileXOffset+pileSpacing, foundationYOffset });
+            break;
+        case Location::Tableau:
+            outline({ stockpileXOffset+(pileSpacing*move.getStartingPile()), tableauYOffset+(move.getCard().getTableauIndex()*tableauYSpacing) });
+            break;
+        case Location::Foundation:
+            outline({ foundationX+move.getStartingPile()*pileSpacing, foundationYOffset });
+            break;
+        default: return;
+    }
+
+    // Where it goes 
+    if (move.getDestination()==Location::Foundation){
+        outline({ foundationX+move.getPile()*pileSpacing, foundationYOffset });
+    } else {
+        float depth=static_cast<float>(game.getTableau(move.getPile()).size());
+        outline({ stockpileXOffset+(pileSpacing*move.getPile()), tableauYOffset+(depth*tableauYSpacing) });
+    }
+}
+
 // ----- Main Handler
-void SolitaireGraphics::draw(sf::RenderWindow& window,const Game& game,bool showWinText) const {
+void SolitaireGraphics::draw(sf::RenderTarget& window,const Game& game) const {
 
     // window - The Solitaire window object 
-    // game - The solitaire game instance storing all game data,
-    // showWinText - Whether the player has won, and as such whether to show a win text 
+    // game - The solitaire game instance storing all game data
 
-    drawFoundations(window, game);
-    drawTableau(window);
-    drawStockpile(window,game);
-    drawDragging(window);
+    updateScene(game);
+    drawDragging();
+    overlay.clear();
+    drawHint();
+
+    if (sheet.usesAtlas()){ // Cards, buttons and outlines all come from the atlas, so two batches on one texture do it 
+        if (pilesRebuilt>0){ // Only when the scene changed, an unchanged frame copies nothing 
+            joined.clear();
+            joined.append(slots);
+            joined.append(scene);
+        }
+        dragged.append(overlay); // What's built every frame anyway goes on top, the buttons last as before 
+        addButtons(dragged);
+        drawCalls=joined.draw(window,&sheet.getTexture());
+        drawCalls+=dragged.draw(window,&sheet.getTexture());
+        return;
+    }
+
+    drawCalls=slots.draw(window,nullptr);
+    drawCalls+=scene.draw(window,&sheet.getTexture()); // Every card still on the table in one call 
+    drawCalls+=dragged.draw(window,&sheet.getTexture());
+    drawCalls+=overlay.draw(window,nullptr);
     drawUndo(window);
     drawNewDeal(window);
+    drawCalls+=2;
 
-}
-
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+// hintengine.cpp
+// Monte Carlo hints over guesses of the hidden cards, see HintEngine.h
+
+#include "HintEngine.h"
+#include "Random.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+HintEngine::HintEngine(const HintConfig& config,int threads) : config(config), pool(threads) {
+
+    SolverConfig solverConfig;
+    solverConfig.maxNodes=config.nodesPerSolve;
+    solverConfig.maxSeconds=0.0; // The hint deadline is checked between guesses instead 
+    solverConfig.tableBytes=16*static_cast<std::size_t>(std::max(config.nodesPerSolve,1024ll)); // Room for every node searched, without growing 
+    for (int i=0;i<pool.size();i++) solvers.push_back(std::make_unique<Solver>(solverConfig));
+
+}
+
+GameState HintEngine::determinize(const GameState& state,std::uint64_t seed){
+
+    // state -- The real position 
+    // seed -- Which guess, the same seed always gives the same guess 
+
+    GameState guess=state;
+    int slots[52];
+    std::uint8_t hidden[52];
+    int count=0;
+    int tableauEnd=state.pileEnd[GameState::Foundation0-1];
+    for (int i=0;i<tableauEnd;i++){ // Reserve, stockpile and Tableau are the first piles 
+        bool inReserve=i<state.pileEnd[GameState::Reserve];
+        bool inTableau=i>=state.pileEnd[GameState::Stockpile];
+        if (inReserve || (inTableau && !(state.cards[i]&GameState::faceUpBit))){
+            slots[count]=i;
+            hidden[count++]=state.cards[i];
+        }
+    }
+
+    Xoshiro256 rng(seed);
+    for (int i=count-1;i>0;i--) std::swap(hidden[i],hidden[rng.below(static_cast<std::uint32_t>(i+1))]);
+    for (int i=0;i<count;i++) guess.cards[slots[i]]=hidden[i]; // All face down, so face up bits are untouched 
+    return guess;
+
+}
+
+HintReport HintEngine::hint(const Game& game,const std::atomic<bool>* cancel,std::uint64_t firstSample){
+
+    // game -- The position to find a move for 
+    // cancel -- Set by another thread to stop early 
+    // firstSample -- Number of the first guess 
+
+    using Clock=std::chrono::steady_clock;
+    auto start=Clock::now();
+    auto deadline=start+std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(config.maxSeconds));
+
+    HintReport report;
+    Game::MoveBuffer buffer;
+    int count=game.generateMoves(buffer);
+    for (int i=0;i<count;i++){
+        report.moves.emplace_back();
+        report.moves.back().move=buffer[i];
+        report.moves.back().index=i;
+    }
+    if (count==0) return report;
+
+    GameState state=game.getState();
+    std::mutex mergeLock;
+    std::atomic<bool> late{false};
+    std::atomic<bool> stopped{false};
+
+    for (int s=0;s<config.samples;s++){
+        pool.submit([&,s]{
+            if (config.maxSeconds>0.0 && Clock::now()>=deadline){
+                late.store(true,std::memory_order_relaxed);
+                return;
+            }
+            if (cancel && cancel->load(std::memory_order_relaxed)){
+                stopped.store(true,std::memory_order_relaxed);
+                return;
+            }
+            Solver& solver=*solvers[pool.currentWorker()];
+            Game guess;
+            guess.setState(determinize(state,config.seed*0x9E3779B97F4A7C15ull+firstSample+static_cast<std::uint64_t>(s)));
+
+            std::vector<SolveResult> results(report.moves.size());
+            for (std::size_t m=0;m<report.moves.size();m++){
+                guess.applyMove(report.moves[m].move); // Only visible cards move, so it is legal in every guess 
+                results[m]=guess.getWon() ? SolveResult::Solved : solver.solve(guess).result;
+                guess.undo();
+            }
+
+            std::lock_guard<std::mutex> lock(mergeLock);
+            for (std::size_t m=0;m<results.size();m++){
+                report.moves[m].samples++;
+                if (results[m]==SolveResult::Solved) report.moves[m].wins++;
+                else if (results[m]==SolveResult::Unsolvable) report.moves[m].losses++;
+            }
+            report.samples++;
+        });
+    }
+    pool.wait();
+
+    std::stable_sort(report.moves.begin(),report.moves.end(),[](const MoveHint& a,const MoveHint& b){
+        if (a.wins!=b.wins) return a.wins>b.wins;
+        return a.losses<b.losses; // Then the move least often proven hopeless 
+    });
+    report.seconds=std::chrono::duration<double>(Clock::now()-start).count();
+    report.deadlineHit=late.load();
+    report.cancelled=stopped.load();
+    return report;
+
+}
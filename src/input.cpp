@@ -16,17 +16,25 @@ void Input::getHovered(sf::RenderWindow& window) {
 
     // window -- The solitaire window
 
+    handleMouse(window.mapPixelToCoords(sf::Mouse::getPosition(window)),sf::Mouse::isButtonPressed(sf::Mouse::Button::Left));
+
+}
+
+void Input::handleMouse(sf::Vector2f mouse,bool mouseDown) {
+
+    // mouse -- Mouse position in window coordinates
+    // mouseDown -- Whether the left button is held
+
+    graphics.mouse=mouse;
+
     float cardWidth  = static_cast<float>(sheet.cardWidth());
     float cardHeight = static_cast<float>(sheet.cardHeight());
 
-    sf::Vector2f mouse = window.mapPixelToCoords(sf::Mouse::getPosition(window));
-    bool mouseDown = sf::Mouse::isButtonPressed(sf::Mouse::Button::Left);
-
     // ---- Check if a dragged card has been 'dropped' somewhere
 
     if (!mouseDown && mouseWasDown && graphics.draggedCard!=nullptr) { // Mouse released
 
-        const Card& draggedCardObj=*graphics.draggedCard;
+        const Card draggedCardObj=*graphics.draggedCard; // A copy, the original moves with the first move applied 
         graphics.draggedCard = nullptr;
         Location startingLocation=draggedCardObj.getLocation();
         int startingPile=-1;
@@ -56,7 +64,7 @@ void Input::getHovered(sf::RenderWindow& window) {
                    i,
                    startingPile
                 ); 
-                game.applyMove(move,false); // Apply this move 
+                play(move); // Apply this move 
             }
         }
 
@@ -81,7 +89,7 @@ void Input::getHovered(sf::RenderWindow& window) {
                    p,
                    startingPile
                 );
-                game.applyMove(move,false); // Apply this move 
+                play(move); // Apply this move 
             }
 
         }
@@ -104,28 +112,32 @@ void Input::getHovered(sf::RenderWindow& window) {
             sf::FloatRect undoRect( // Establish hitbox for the undo button
                 {graphics.undoXOffset,  
                 graphics.undoYOffset},  
-                {static_cast<float>(sheet.getUndo().getSize().x),
-                static_cast<float>(sheet.getUndo().getSize().y)}
+                sf::Vector2f(sheet.getUndoRect().size)
             );
 
             sf::FloatRect newDealRect( // Establish hitbox for the new deal button
                 {graphics.newDealXOffset,  
                 graphics.newDealYOffset},  
-                {static_cast<float>(sheet.getNewDeal().getSize().x),
-                static_cast<float>(sheet.getNewDeal().getSize().y)}
+                sf::Vector2f(sheet.getNewDealRect().size)
             );
 
             if (stockRect.contains(mouse)) {
                 if (!game.getReserve().empty()) { // Player wants to deal
                     game.dealFromReserve();  
+                    if (recorder) recorder->draw();
                 } else { // Player wants to reset the reserve, i.e. bring all stockpile cards back to reset
                     game.resetStockpile();
+                    if (recorder) recorder->recycle();
                 }
+                autoComplete();
                 dealClock.restart();
-            } else if (undoRect.contains(mouse)){ // Player would like to undo a move
+            } else if (undoRect.contains(mouse)){ // Player would like to undo a move, not auto completed so the undone moves can be redone 
                 game.undo();
+                if (recorder) recorder->undo();
             } else if (newDealRect.contains(mouse)){ // Player would like a new deal
                 game.dealNewGame();
+                if (recorder) recorder->deal(game.getDealSeed());
+                autoComplete(); // Sends up the aces it was dealt with 
             }
 
         }
@@ -196,3 +208,22 @@ void Input::getHovered(sf::RenderWindow& window) {
     mouseWasDown = mouseDown; // Remember the state for the next frame 
 
 }
+
+void Input::play(const Move& move){
+
+    // move -- Move built from where the player dropped a card 
+
+    if (!game.applyMove(move)) return;
+    if (recorder) recorder->move(move);
+    autoComplete();
+
+}
+
+void Input::autoComplete(){
+
+    // -- Sends up whatever the last change made safe, the cascade undoes together with that move. Called after every
+    // play, draw, recycle and new deal, but not an undo 
+
+    if (game.autoComplete()>0 && recorder) recorder->autoComplete();
+
+}
\ No newline at end of file
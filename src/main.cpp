@@ -3,45 +3,234 @@
 
 #include <optional>
 #include <SFML/Graphics.hpp>
+#include "AnalysisWorker.h"
 #include "Game.h"
 #include "Spritesheet.h"
 #include "Graphics.h"
+#include "Resources.h"
 #include "Input.h"
+#include "Snapshot.h"
+#include "TimingStats.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
 #include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+// CPU use and loop wakeups over stretches of at least a second, split by whether the player did anything in them, so
+// the idle figures are what an untouched window costs 
+class ActivityStats{
+
+public:
+
+    void wakeup() { wakeups++; }
+    void input() { sawInput=true; }
+
+    // -- Closes the current stretch once it has run a second 
+    void tick(){
+        auto now=std::chrono::steady_clock::now();
+        double seconds=std::chrono::duration<double>(now-start).count();
+        if (seconds<1.0) return;
+        double cpu=static_cast<double>(std::clock()-cpuStart)/CLOCKS_PER_SEC; // Process CPU time, analysis threads included 
+        Totals& totals=sawInput ? active : idle;
+        totals.seconds+=seconds;
+        totals.cpu+=cpu;
+        totals.wakeups+=wakeups;
+        start=now;
+        cpuStart=std::clock();
+        wakeups=0;
+        sawInput=false;
+    }
+
+    void print(std::ostream& out) const{
+        auto line=[&](const char* name,const Totals& t){
+            out << name << " " << t.seconds << " s  CPU " << (t.seconds>0 ? 100.0*t.cpu/t.seconds : 0.0) << "% of a core  "
+                << (t.seconds>0 ? t.wakeups/t.seconds : 0.0) << " wakeups/sec\n";
+        };
+        line("idle  ",idle);
+        line("active",active);
+    }
+
+private:
+
+    struct Totals{
+        double seconds=0.0;
+        double cpu=0.0;
+        long long wakeups=0;
+    };
+
+    std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+    std::clock_t cpuStart=std::clock();
+    long long wakeups=0;
+    bool sawInput=false;
+    Totals idle;
+    Totals active;
+
+};
+
+// Whether any card shows its back, so the back animation has to keep running 
+bool showsBacks(const Game& game){
+    if (!game.getReserve().empty()) return true;
+    for (int i=0;i<7;i++){
+        if (!game.getTableau(i).empty() && !game.getTableau(i).front().getFaceUp()) return true;
+    }
+    return false;
+}
+
+}
 
 // -- The main function for this Solitaire gmae 
-int main() {
+// Usage: solitaire [--record file] [--stats]
+//   --record saves every action to file for solitaire-replay 
+//   --stats prints each asset's GPU memory and load time, then frame time, hint latency, and idle and active CPU use
+//   and wakeups on exit 
+// In game, H shows or hides the suggested move 
+// The loop sleeps in waitEvent until something needs showing: input, a drag, the back card animation's next step or,
+// while hints are shown, a better hint. It only renders when one of those changed the picture 
+int main(int argc, char** argv) {
+
+    SessionRecorder recorder;
+    bool printStats=false;
+    for (int i=1;i<argc;i++){
+        if (std::string(argv[i])=="--record" && i+1<argc){
+            if (!recorder.open(argv[++i])){
+                std::cerr << "Could not create recording " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (std::string(argv[i])=="--stats"){
+            printStats=true;
+        }
+    }
 
     sf::RenderWindow window(sf::VideoMode({ 1024u, 768u }), "Solitaire");
     window.setFramerateLimit(140);
 
     // Load all assets
-    Spritesheet sheet;
-    sf::Font font;
-    if (!sheet.loadFromFile("assets/Spritesheet.png")) return 1;
-    if (!sheet.loadUndo("assets/Undo.png")) return 1;
-    if (!sheet.loadNewDeal("assets/NewDeal.png")) return 1;
-    if (!font.openFromFile("assets/arial.ttf")) return 1;
+    Resources resources; // Owns every texture, everything else borrows them 
+    Spritesheet sheet(resources);
+    if (!sheet.loadAtlas("assets/atlas.png","assets/atlas.bin")){ // Built by make atlas, without it each picture is its own texture 
+        if (!sheet.loadFromFile("assets/Spritesheet.png")) return 1;
+        if (!sheet.loadUndo("assets/Undo.png")) return 1;
+        if (!sheet.loadNewDeal("assets/NewDeal.png")) return 1;
+    }
+    if (printStats) resources.report(std::cout);
 
     // Establish our essential objects
+    const std::string savePath="solitaire.snapshot"; // The game in progress when the window was last closed 
     Game game;
-    game.dealNewGame();
-    SolitaireGraphics graphics(sheet,font,game);
+    bool freshDeal=recorder.isOpen() || !loadSnapshot(game,savePath); // A recording starts from a fresh deal 
+    if (freshDeal) game.dealNewGame();
+    SolitaireGraphics graphics(sheet,game);
     Input input(game,graphics,sheet);
+    if (recorder.isOpen()){
+        recorder.deal(game.getDealSeed());
+        input.setRecorder(&recorder);
+    }
+    if (freshDeal) input.autoComplete(); // Sends up the aces it was dealt with, as the new deal button does 
 
-    while (window.isOpen()) { 
+    // Hints are worked out on a background thread, the loop only hands over positions and reads back the answer 
+    // Only while hints are showing, and on at most half the cores so a long analysis doesn't take over the machine 
+    AnalysisConfig analysisConfig;
+    analysisConfig.threads=std::max(1,std::min(4,static_cast<int>(std::thread::hardware_concurrency())/2));
+    AnalysisWorker analysis(analysisConfig);
+    std::uint64_t analysedRevision=0;
+    bool showHints=false;
+    AnalysisWorker::Suggestion shownHint; // The suggestion on screen, to tell when a better one arrives 
+    const sf::Time hintPoll=sf::milliseconds(50); // How often to look for a better hint while the worker is busy 
+    TimingStats frameTimes;
+    ActivityStats activity;
+    sf::Vector2f mouse;
+    bool mouseDown=false;
+    bool redraw=true;
 
-        while (const std::optional<sf::Event> event = window.pollEvent()) { // Player has initiated an event 
-            if (event->is<sf::Event::Closed>()) { // Player wants to close the window 
-                window.close(); // Close the window  
+    // -- Applies one event, noting whether it changed what's on screen 
+    auto handle=[&](const sf::Event& event){
+        if (event.is<sf::Event::Closed>()) { // Player wants to close the window 
+            saveSnapshot(game,savePath); // Carry on from here next time 
+            if (recorder.isOpen()) recorder.finish(game);
+            window.close(); // Close the window  
+            return;
+        }
+        if (const auto* key = event.getIf<sf::Event::KeyPressed>()) {
+            if (key->code==sf::Keyboard::Key::H){ // Toggle the suggested move 
+                showHints=!showHints;
+                if (!showHints){ // Nothing to work out until they're back, which submits the position then 
+                    analysis.stop();
+                    analysedRevision=0;
+                }
+                redraw=true;
             }
+        } else if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) {
+            mouse=window.mapPixelToCoords(moved->position);
+            if (!mouseDown) return; // Nothing follows the mouse unless a button is held 
+        } else if (const auto* pressed = event.getIf<sf::Event::MouseButtonPressed>()) {
+            if (pressed->button!=sf::Mouse::Button::Left) return;
+            mouse=window.mapPixelToCoords(pressed->position);
+            mouseDown=true;
+        } else if (const auto* released = event.getIf<sf::Event::MouseButtonReleased>()) {
+            if (released->button!=sf::Mouse::Button::Left) return;
+            mouse=window.mapPixelToCoords(released->position);
+            mouseDown=false;
+        } else if (event.is<sf::Event::Resized>() || event.is<sf::Event::FocusGained>()) {
+            redraw=true; // The window may have been uncovered 
+            return;
+        } else {
+            return;
         }
+        activity.input();
+        if (event.is<sf::Event::KeyPressed>()) return;
+        input.handleMouse(mouse,mouseDown); // Picks up, drags, drops and clicks 
+        redraw=true;
+    };
+
+    while (window.isOpen()) { 
+
+        // Sleep until an event, or until the next thing that changes by itself is due. Zero waits for an event however long 
+        if (!redraw){
+            sf::Time timeout=sf::Time::Zero;
+            if (showsBacks(game)) timeout=std::max(sheet.untilNextBack(),sf::milliseconds(1));
+            if (showHints && analysis.busy() && (timeout==sf::Time::Zero || hintPoll<timeout)) timeout=hintPoll;
+            if (const std::optional<sf::Event> event = window.waitEvent(timeout)) handle(*event);
+            activity.wakeup();
+        }
+        while (const std::optional<sf::Event> event = window.pollEvent()) handle(*event); // Everything else that queued up 
+        activity.tick();
+        if (!window.isOpen()) break;
+
+        if (showHints && game.getRevision()!=analysedRevision){ // Hints just came on or the position changed, analyse it 
+            analysedRevision=game.getRevision();
+            analysis.submit(game.getState(),analysedRevision);
+        }
+        if (showsBacks(game) && sheet.untilNextBack()<=sf::Time::Zero) redraw=true; // The back card moves on 
+        AnalysisWorker::Suggestion suggestion=showHints ? analysis.suggestion() : AnalysisWorker::Suggestion();
+        if (suggestion.valid!=shownHint.valid || suggestion.revision!=shownHint.revision || suggestion.moveIndex!=shownHint.moveIndex) redraw=true;
+        if (!redraw) continue;
+
+        sf::Clock frameClock;
+        Move hint;
+        graphics.hint.reset();
+        if (showHints && analysis.suggestedMove(game,hint)) graphics.hint=hint;
+        shownHint=suggestion;
 
         window.clear(sf::Color(0, 120, 0)); // Establish a green background 
-        input.getHovered(window); // Establish any hovered cards ( Cards that the mouse is on top of for dragging/release )
-        graphics.draw(window, game,false); // Render 
+        graphics.draw(window, game); // Render 
         window.display(); // Display 
+        frameTimes.add(frameClock.getElapsedTime().asSeconds());
+        redraw=false;
+
+    }
 
+    if (printStats){
+        TimingStats latency=analysis.latency();
+        std::cout << "frame ms  p50 " << frameTimes.percentile(0.5)*1000.0 << "  p90 " << frameTimes.percentile(0.9)*1000.0
+                  << "  p99 " << frameTimes.percentile(0.99)*1000.0 << "  max " << frameTimes.max()*1000.0
+                  << "  ( " << frameTimes.count() << " frames )\n";
+        std::cout << "move to first hint ms  p50 " << latency.percentile(0.5)*1000.0 << "  p90 " << latency.percentile(0.9)*1000.0
+                  << "  p99 " << latency.percentile(0.99)*1000.0 << "  ( " << latency.count() << " positions )\n";
+        activity.print(std::cout);
     }
 
     return 0;
@@ -0,0 +1,104 @@
+// mappedfile.cpp
+// Platform specific half of MappedFile, see MappedFile.h
+
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept{
+    *this=std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept{
+    if (this==&other) return *this;
+    close();
+    std::swap(bytes,other.bytes);
+    std::swap(length,other.length);
+#ifdef _WIN32
+    std::swap(fileHandle,other.fileHandle);
+    std::swap(mappingHandle,other.mappingHandle);
+#endif
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path){
+
+    // path -- File to map 
+
+    close();
+    HANDLE file=CreateFileA(path.c_str(),GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+    if (file==INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file,&fileSize) || fileSize.QuadPart==0){
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping=CreateFileMappingA(file,nullptr,PAGE_READONLY,0,0,nullptr);
+    if (!mapping){
+        CloseHandle(file);
+        return false;
+    }
+    void* view=MapViewOfFile(mapping,FILE_MAP_READ,0,0,0);
+    if (!view){
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    bytes=static_cast<const unsigned char*>(view);
+    length=static_cast<std::size_t>(fileSize.QuadPart);
+    fileHandle=file;
+    mappingHandle=mapping;
+    return true;
+}
+
+void MappedFile::close(){
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    bytes=nullptr;
+    length=0;
+    fileHandle=nullptr;
+    mappingHandle=nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path){
+
+    // path -- File to map 
+
+    close();
+    int fd=::open(path.c_str(),O_RDONLY);
+    if (fd<0) return false;
+    struct stat info;
+    if (fstat(fd,&info)!=0 || info.st_size==0){
+        ::close(fd);
+        return false;
+    }
+    void* view=mmap(nullptr,static_cast<std::size_t>(info.st_size),PROT_READ,MAP_SHARED,fd,0);
+    ::close(fd); // The mapping keeps the file alive 
+    if (view==MAP_FAILED) return false;
+    bytes=static_cast<const unsigned char*>(view);
+    length=static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close(){
+    if (bytes) munmap(const_cast<unsigned char*>(bytes),length);
+    bytes=nullptr;
+    length=0;
+}
+
+#endif
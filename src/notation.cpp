@@ -0,0 +1,197 @@
+// notation.cpp
+// Reads and writes the text notation described in Notation.h
+
+#include "Notation.h"
+#include "GameState.h"
+#include <cctype>
+
+namespace {
+
+const char* const valueChars="A23456789TJQK"; // Indexed by Value
+const char* const suitChars="SHCD"; // Indexed by Suit
+
+// -- Parses a pile reference such as "t3" or "f0", returns false on malformed input
+bool parsePile(std::string_view text, size_t& pos, char& kind, int& pile){
+
+    // text -- The full move text 
+    // pos -- Where to start reading, advanced past the pile reference
+    // kind -- Set to 'w', 't' or 'f'
+    // pile -- Set to the pile index, -1 for the stockpile
+
+    if (pos>=text.size()) return false;
+    kind=static_cast<char>(std::tolower(static_cast<unsigned char>(text[pos++])));
+    if (kind=='w'){
+        pile=-1;
+        return true;
+    }
+    if ((kind!='t' && kind!='f') || pos>=text.size() || !std::isdigit(static_cast<unsigned char>(text[pos]))) return false;
+    pile=text[pos++]-'0';
+    return kind=='t' ? pile<7 : pile<4;
+}
+
+}
+
+std::string formatCard(const Card& card){
+    if (!card.getFaceUp()) return "##";
+    std::string text;
+    text+=valueChars[static_cast<int>(card.getValue())];
+    text+=suitChars[static_cast<int>(card.getSuit())];
+    return text;
+}
+
+std::string formatMove(const Move& move){
+
+    const Card& card=move.getCard();
+    std::string text;
+
+    switch (move.getStartingPosition()){
+        case Location::Reserve: return "draw";
+        case Location::Stockpile:
+            if (move.getDestination()==Location::Reserve) return "recycle";
+            text="w";
+            break;
+        case Location::Tableau:
+            text="t"+std::to_string(move.getStartingPile());
+            if (card.getTableauIndex()>=0) text+=":"+std::to_string(card.getTableauIndex());
+            break;
+        case Location::Foundation: text="f"+std::to_string(move.getStartingPile()); break;
+        default: return "?";
+    }
+
+    text+=">";
+    text+=move.getDestination()==Location::Foundation ? "f" : "t";
+    text+=std::to_string(move.getPile());
+    return text;
+}
+
+bool parseMove(const Game& game, std::string_view text, Move& move){
+
+    // game -- The position the move is made against, used to look up the moving card
+    // text -- The move in notation, i.e. "t2:4>t5"
+    // move -- Set to the parsed move on success
+
+    if (text=="draw"){
+        move=Move(game.getReserve().empty() ? Card() : game.getReserve().back(),Location::Reserve,Location::Stockpile,-1,-1);
+        return true;
+    }
+    if (text=="recycle"){
+        move=Move(game.getStockpile().empty() ? Card() : game.getStockpile().back(),Location::Stockpile,Location::Reserve,-1,-1);
+        return true;
+    }
+
+    size_t pos=0;
+    char fromKind, toKind;
+    int fromPile, toPile;
+    if (!parsePile(text,pos,fromKind,fromPile)) return false;
+
+    int fromIndex=-1; // Tableau card index, -1 means the top card
+    if (fromKind=='t' && pos<text.size() && text[pos]==':'){
+        pos++;
+        if (pos>=text.size() || !std::isdigit(static_cast<unsigned char>(text[pos]))) return false;
+        fromIndex=0;
+        while (pos<text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))){
+            fromIndex=fromIndex*10+(text[pos++]-'0');
+            if (fromIndex>=52) return false; // No pile is that tall, and it keeps untrusted input from overflowing
+        }
+    }
+
+    if (pos>=text.size() || text[pos++]!='>') return false;
+    if (!parsePile(text,pos,toKind,toPile) || toKind=='w' || pos!=text.size()) return false;
+
+    const std::vector<Card>* source=nullptr;
+    Location start=Location::Stockpile;
+    if (fromKind=='w'){
+        source=&game.getStockpile();
+    } else if (fromKind=='t'){
+        source=&game.getTableau(fromPile);
+        start=Location::Tableau;
+    } else {
+        source=&game.getFoundation(fromPile);
+        start=Location::Foundation;
+    }
+    if (source->empty()) return false;
+    if (fromIndex<0) fromIndex=static_cast<int>(source->size())-1;
+    if (fromIndex>=static_cast<int>(source->size())) return false;
+
+    move=Move(
+        (*source)[fromIndex],
+        start,
+        toKind=='t' ? Location::Tableau : Location::Foundation,
+        toPile,
+        fromPile
+    );
+    return true;
+}
+
+namespace {
+
+// Pile id of where a move starts or ends 
+int pileId(Location location,int pile){
+    switch (location){
+        case Location::Reserve: return GameState::Reserve;
+        case Location::Stockpile: return GameState::Stockpile;
+        case Location::Tableau: return GameState::Tableau0+pile;
+        default: return GameState::Foundation0+pile;
+    }
+}
+
+Location pileLocation(int id){
+    if (id==GameState::Reserve) return Location::Reserve;
+    if (id==GameState::Stockpile) return Location::Stockpile;
+    if (id<GameState::Foundation0) return Location::Tableau;
+    return Location::Foundation;
+}
+
+// Index of a pile within its kind, i.e. 2 for Tableau pile 2, -1 for the reserve and stockpile 
+int pileNumber(int id){
+    if (id<GameState::Tableau0) return -1;
+    if (id<GameState::Foundation0) return id-GameState::Tableau0;
+    return id-GameState::Foundation0;
+}
+
+}
+
+void movePiles(const Move& move, int& from, int& to, int& index){
+    from=pileId(move.getStartingPosition(),move.getStartingPile());
+    to=pileId(move.getDestination(),move.getPile());
+    index=move.getStartingPosition()==Location::Tableau ? move.getCard().getTableauIndex() : 0;
+}
+
+bool pileMove(const Game& game, int from, int to, int index, Move& move){
+
+    if (from<0 || to<0 || from>=GameState::PileCount || to>=GameState::PileCount) return false;
+    Location start=pileLocation(from);
+    int fromPile=pileNumber(from);
+
+    const std::vector<Card>* source=nullptr;
+    if (start==Location::Reserve) source=&game.getReserve();
+    else if (start==Location::Stockpile) source=&game.getStockpile();
+    else if (start==Location::Tableau) source=&game.getTableau(fromPile);
+    else source=&game.getFoundation(fromPile);
+    if (source->empty()) return false;
+
+    if (start!=Location::Tableau) index=static_cast<int>(source->size())-1;
+    if (index<0 || index>=static_cast<int>(source->size())) return false;
+
+    move=Move((*source)[index],start,pileLocation(to),pileNumber(to),fromPile);
+    return true;
+}
+
+void printGame(std::ostream& out, const Game& game){
+
+    out << "reserve: " << game.getReserve().size() << " cards\n";
+    out << "waste:  ";
+    for (const Card& c : game.getStockpile()) out << ' ' << formatCard(c);
+    out << '\n';
+    for (int i=0;i<4;i++){
+        out << "f" << i << ":     ";
+        if (!game.getFoundation(i).empty()) out << ' ' << formatCard(game.getFoundation(i).back());
+        out << '\n';
+    }
+    for (int i=0;i<7;i++){
+        out << "t" << i << ":     ";
+        for (const Card& c : game.getTableau(i)) out << ' ' << formatCard(c);
+        out << '\n';
+    }
+    if (game.getWon()) out << "won\n";
+}
@@ -0,0 +1,124 @@
+// parallelsolver.cpp
+// Parallel Solver search over a work stealing pool, see ParallelSolver.h
+
+#include "ParallelSolver.h"
+#include <chrono>
+
+namespace {
+
+double now(){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+ParallelSolver::ParallelSolver(const SolverConfig& config,int threads)
+: config(config), pool(threads), table(config.tableBytes) {
+
+    SolverConfig workerConfig=config;
+    workerConfig.tableBytes=0; // Workers use the shared table, their own stays at its minimum size 
+    workerConfig.findShortest=false;
+    for (int i=0;i<pool.size();i++){
+        workers.push_back(std::make_unique<Solver>(workerConfig));
+        workers.back()->parallel=this;
+    }
+
+}
+
+void ParallelSolver::chargeNodes(long long count){
+
+    // count -- Nodes a worker expanded since it last reported 
+
+    long long total=nodes.fetch_add(count,std::memory_order_relaxed)+count;
+    if (config.maxNodes>0 && total>=config.maxNodes) stop.store(true,std::memory_order_relaxed);
+    if (config.maxSeconds>0.0 && now()-startTime>=config.maxSeconds) stop.store(true,std::memory_order_relaxed);
+
+}
+
+bool ParallelSolver::wantsWork(int depth) const{
+    return depth<maxSplitDepth && pool.idleWorkers()>0 && pool.queuedTasks()==0;
+}
+
+void ParallelSolver::report(const std::vector<Move>& path){
+
+    // path -- The winning line from the root 
+
+    std::lock_guard<std::mutex> guard(solutionLock);
+    if (!solved){
+        solved=true;
+        solution=path;
+    }
+    stop.store(true,std::memory_order_relaxed);
+
+}
+
+void ParallelSolver::split(Solver& from,std::size_t firstStep,std::size_t endStep,int depth){
+
+    // from -- The worker giving away steps, its game is at the node the steps belong to 
+    // firstStep, endStep -- Range of from's step stack to give away
+    // depth -- Depth of the positions the steps lead to 
+
+    for (std::size_t i=firstStep;i<endStep;i++){
+        Solver::Step step=from.steps[i];
+        from.play(step);
+        GameState state=from.game.getState();
+        std::vector<Move> path=from.path;
+        from.takeBack(step);
+        pool.submit([this,state,path,depth]{ runTask(state,path,depth); });
+    }
+
+}
+
+void ParallelSolver::runTask(const GameState& state,const std::vector<Move>& path,int depth){
+
+    // state -- Position to search below 
+    // path -- Moves from the root to state 
+    // depth -- Search depth of state 
+
+    if (stopRequested()) return;
+
+    Solver& worker=*workers[pool.currentWorker()];
+    worker.game.setState(state);
+    worker.path=path;
+    worker.steps.clear();
+    worker.stopped=false;
+    worker.truncated=false;
+    worker.unchargedNodes=0;
+
+    worker.search(depth);
+
+    chargeNodes(worker.unchargedNodes);
+    if (worker.truncated) truncated.store(true,std::memory_order_relaxed);
+
+}
+
+SolveOutcome ParallelSolver::solve(const Game& game){
+
+    // game -- The position to solve from 
+
+    table.clear();
+    stop.store(false);
+    truncated.store(false);
+    nodes.store(0);
+    solution.clear();
+    solved=false;
+    startTime=now();
+
+    GameState root=game.getState();
+    pool.submit([this,root]{ runTask(root,std::vector<Move>(),0); });
+    pool.wait();
+
+    SolveOutcome outcome;
+    outcome.stats.nodes=nodes.load();
+    outcome.stats.seconds=now()-startTime;
+    outcome.stats.tableBytes=table.bytes();
+    outcome.stats.tableEntries=table.entries();
+    if (solved){
+        outcome.result=SolveResult::Solved;
+        outcome.solution=solution;
+    } else if (!stop.load() && !truncated.load()){
+        outcome.result=SolveResult::Unsolvable;
+    }
+    return outcome;
+
+}
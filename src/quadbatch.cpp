@@ -0,0 +1,59 @@
+// quadbatch.cpp
+// Batched rectangle drawing, see QuadBatch.h
+
+#include "QuadBatch.h"
+
+void QuadBatch::addQuad(sf::FloatRect where,sf::FloatRect texture,sf::Color color){
+
+    // where -- Rectangle on the target 
+    // texture -- Rectangle of the texture in pixels, ignored when drawn without one 
+    // color -- Vertex colour, white shows the texture as it is 
+
+    float left=where.position.x, top=where.position.y;
+    float right=left+where.size.x, bottom=top+where.size.y;
+    float u0=texture.position.x, v0=texture.position.y;
+    float u1=u0+texture.size.x, v1=v0+texture.size.y;
+
+    vertices.append(sf::Vertex{{left,top},color,{u0,v0}});
+    vertices.append(sf::Vertex{{right,top},color,{u1,v0}});
+    vertices.append(sf::Vertex{{left,bottom},color,{u0,v1}});
+    vertices.append(sf::Vertex{{left,bottom},color,{u0,v1}});
+    vertices.append(sf::Vertex{{right,top},color,{u1,v0}});
+    vertices.append(sf::Vertex{{right,bottom},color,{u1,v1}});
+
+}
+
+void QuadBatch::add(sf::FloatRect where,const sf::IntRect& textureRect){
+    addQuad(where,sf::FloatRect(textureRect),sf::Color::White);
+}
+
+void QuadBatch::addOutline(sf::FloatRect where,float thickness,sf::Color color,sf::Vector2f solidTexel){
+
+    // -- Four strips around where, the same pixels sf::RectangleShape::setOutlineThickness covers 
+
+    float left=where.position.x-thickness, top=where.position.y-thickness;
+    float outerWidth=where.size.x+2.f*thickness;
+    sf::FloatRect texel{solidTexel,{0.f,0.f}}; // Every corner on the one pixel 
+    addQuad({{left,top},{outerWidth,thickness}},texel,color); // Top 
+    addQuad({{left,where.position.y+where.size.y},{outerWidth,thickness}},texel,color); // Bottom 
+    addQuad({{left,where.position.y},{thickness,where.size.y}},texel,color); // Left 
+    addQuad({{where.position.x+where.size.x,where.position.y},{thickness,where.size.y}},texel,color); // Right 
+
+}
+
+void QuadBatch::append(const QuadBatch& other){
+    for (std::size_t i=0;i<other.vertices.getVertexCount();i++) vertices.append(other.vertices[i]);
+}
+
+int QuadBatch::draw(sf::RenderTarget& target,const sf::Texture* texture) const{
+
+    // target -- Where to draw 
+    // texture -- Texture the texture rectangles index, nullptr for plain colour 
+
+    if (vertices.getVertexCount()==0) return 0;
+    sf::RenderStates states;
+    states.texture=texture;
+    target.draw(vertices,states);
+    return 1;
+
+}
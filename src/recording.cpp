@@ -0,0 +1,162 @@
+// recording.cpp
+// Session recording and replay, see Recording.h for the file layout
+
+#include "Recording.h"
+#include "GameState.h"
+#include "MappedFile.h"
+#include "Notation.h"
+#include <cstring>
+
+SessionRecorder::~SessionRecorder(){
+    if (out) std::fclose(out);
+}
+
+bool SessionRecorder::open(const std::string& path){
+
+    // path -- Recording file, replaced if it exists 
+
+    if (out) std::fclose(out);
+    out=std::fopen(path.c_str(),"wb");
+    if (!out) return false;
+    std::uint16_t version[2]={currentVersion,0};
+    std::fwrite(magicBytes,sizeof(magicBytes),1,out);
+    std::fwrite(version,sizeof(version),1,out);
+    start=std::chrono::steady_clock::now();
+    return true;
+
+}
+
+void SessionRecorder::write(RecordedAction action,int from,int to,int index){
+
+    if (!out) return;
+    RecordedEvent event;
+    event.millis=static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-start).count());
+    event.action=action;
+    event.from=static_cast<std::uint8_t>(from);
+    event.to=static_cast<std::uint8_t>(to);
+    event.index=static_cast<std::uint8_t>(index);
+    std::fwrite(&event,sizeof(event),1,out); // Buffered, a session's worth fits in a few writes 
+
+}
+
+void SessionRecorder::deal(std::uint64_t seed){
+
+    // seed -- Deal number the game was dealt with 
+
+    write(RecordedAction::Deal);
+    if (out) std::fwrite(&seed,sizeof(seed),1,out);
+
+}
+
+void SessionRecorder::move(const Move& move){
+
+    // move -- A move applyMove has just accepted 
+
+    int from,to,index;
+    movePiles(move,from,to,index);
+    write(RecordedAction::Move,from,to,index);
+
+}
+
+bool SessionRecorder::finish(const Game& game){
+
+    // game -- The game as the session left it 
+
+    if (!out) return false;
+    write(RecordedAction::End);
+    std::uint64_t hash=game.getHash();
+    std::fwrite(&hash,sizeof(hash),1,out);
+    bool written=!std::ferror(out);
+    written=std::fclose(out)==0 && written;
+    out=nullptr;
+    return written;
+
+}
+
+ReplayResult replayRecording(const unsigned char* data,std::size_t size,Game& game){
+
+    // data -- The whole recording 
+    // size -- Its length in bytes 
+    // game -- Game to replay into, left at the final position 
+
+    ReplayResult result;
+    std::uint16_t version=0;
+    if (size<8 || std::memcmp(data,SessionRecorder::magicBytes,4)!=0){
+        result.error="not a recording";
+        return result;
+    }
+    std::memcpy(&version,data+4,sizeof(version));
+    if (version!=SessionRecorder::currentVersion){
+        result.error="recording version "+std::to_string(version);
+        return result;
+    }
+
+    std::size_t pos=8;
+    bool dealt=false;
+    auto fail=[&](const char* why){
+        result.error="event "+std::to_string(result.events)+": "+why;
+        return result;
+    };
+
+    while (pos+sizeof(RecordedEvent)<=size){
+        RecordedEvent event;
+        std::memcpy(&event,data+pos,sizeof(event));
+        pos+=sizeof(event);
+        result.millis=event.millis;
+
+        std::uint64_t payload=0;
+        if (event.action==RecordedAction::Deal || event.action==RecordedAction::End){
+            if (pos+sizeof(payload)>size) return fail("cut short");
+            std::memcpy(&payload,data+pos,sizeof(payload));
+            pos+=sizeof(payload);
+        }
+        if (!dealt && event.action!=RecordedAction::Deal) return fail("recording doesn't start with a deal");
+
+        switch (event.action){
+            case RecordedAction::Deal:
+                game.dealNewGame(payload);
+                dealt=true;
+                break;
+            case RecordedAction::Move:{
+                Move move;
+                if (!pileMove(game,event.from,event.to,event.index,move)) return fail("move names a card that isn't there");
+                if (!game.applyMove(move)) return fail("illegal move");
+                result.moves++;
+                break;
+            }
+            case RecordedAction::Draw: game.dealFromReserve(); break;
+            case RecordedAction::Recycle: game.resetStockpile(); break;
+            case RecordedAction::Undo: game.undo(); break;
+            case RecordedAction::Redo: game.redo(); break;
+            case RecordedAction::AutoComplete: game.autoComplete(); break;
+            case RecordedAction::End:
+                result.events++;
+                result.complete=true;
+                if (game.getHash()!=payload) return fail("final position differs from the recorded one");
+                if (pos!=size) return fail("data after the end");
+                result.ok=true;
+                return result;
+            default:
+                return fail("unknown action");
+        }
+        result.events++;
+    }
+
+    return fail("no end event, the session didn't finish recording");
+
+}
+
+ReplayResult replayFile(const std::string& path,Game& game){
+
+    // path -- Recording file 
+    // game -- Game to replay into 
+
+    MappedFile file;
+    if (!file.open(path)){
+        ReplayResult result;
+        result.error="can't open";
+        return result;
+    }
+    return replayRecording(file.data(),file.size(),game);
+
+}
@@ -0,0 +1,78 @@
+// resources.cpp
+// Loads and owns front-end assets, see Resources.h
+
+#include "Resources.h"
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+
+namespace {
+
+std::size_t fileSize(const std::string& path){
+    std::error_code error;
+    auto size=std::filesystem::file_size(path,error);
+    return error ? 0 : static_cast<std::size_t>(size);
+}
+
+}
+
+const sf::Texture* Resources::texture(const std::string& path){
+
+    // path -- Image file, i.e. "assets/Spritesheet.png" 
+
+    auto found=textures.find(path);
+    if (found!=textures.end()) return found->second.get();
+
+    auto start=std::chrono::steady_clock::now();
+    auto loaded=std::make_unique<sf::Texture>();
+    if (!loaded->loadFromFile(path)) return nullptr;
+
+    AssetInfo asset;
+    asset.path=path;
+    asset.size=loaded->getSize();
+    asset.gpuBytes=static_cast<std::size_t>(asset.size.x)*asset.size.y*4;
+    asset.fileBytes=fileSize(path);
+    asset.loadSeconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    info.push_back(asset);
+    return textures.emplace(path,std::move(loaded)).first->second.get();
+
+}
+
+const sf::Font* Resources::font(const std::string& path){
+
+    // path -- Font file, i.e. "assets/arial.ttf" 
+
+    auto found=fonts.find(path);
+    if (found!=fonts.end()) return found->second.get();
+
+    auto start=std::chrono::steady_clock::now();
+    auto loaded=std::make_unique<sf::Font>();
+    if (!loaded->openFromFile(path)) return nullptr;
+
+    AssetInfo asset;
+    asset.path=path;
+    asset.font=true;
+    asset.fileBytes=fileSize(path);
+    asset.loadSeconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    info.push_back(asset);
+    return fonts.emplace(path,std::move(loaded)).first->second.get();
+
+}
+
+std::size_t Resources::gpuBytes() const{
+    std::size_t total=0;
+    for (const AssetInfo& asset : info) total+=asset.gpuBytes;
+    return total;
+}
+
+void Resources::report(std::ostream& out) const{
+    double seconds=0.0;
+    for (const AssetInfo& asset : info){
+        out << asset.path << "  ";
+        if (asset.font) out << "font, " << asset.fileBytes/1024.0 << " KiB file";
+        else out << asset.size.x << "x" << asset.size.y << ", " << asset.gpuBytes/1024.0 << " KiB GPU";
+        out << ", loaded in " << asset.loadSeconds*1000.0 << " ms\n";
+        seconds+=asset.loadSeconds;
+    }
+    out << info.size() << " assets, " << gpuBytes()/1024.0 << " KiB GPU, " << seconds*1000.0 << " ms to load\n";
+}
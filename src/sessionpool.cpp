@@ -0,0 +1,82 @@
+// sessionpool.cpp
+// Block storage and free list behind SessionPool, see SessionPool.h
+
+#include "SessionPool.h"
+#include <algorithm>
+
+SessionPool::SessionPool(std::uint32_t capacity) : capacity(std::min(capacity,maxSlots)){
+    blocks.reserve((this->capacity>>blockBits)+1); // The block table itself never reallocates
+}
+
+bool SessionPool::grow(){
+
+    // -- Allocates the next block and deals every game in it once, so each already holds its card storage
+
+    if (slotCount>=capacity) return false;
+    std::uint32_t count=std::min(1u<<blockBits,capacity-slotCount);
+    blocks.emplace_back(new Slot[1u<<blockBits]);
+    for (std::uint32_t i=count;i-->0;){
+        Slot& s=slot(slotCount+i);
+        s.game.dealNewGame(0);
+        s.nextFree=freeHead;
+        freeHead=slotCount+i;
+    }
+    slotCount+=count;
+    return true;
+
+}
+
+std::uint32_t SessionPool::open(std::uint64_t seed){
+
+    // seed -- Deal number of the session's game
+
+    if (freeHead==noSlot && !grow()) return 0;
+    std::uint32_t index=freeHead;
+    Slot& s=slot(index);
+    freeHead=s.nextFree;
+    s.open=true;
+    s.game.dealNewGame(seed); // Clears the previous session's history, keeping its storage
+    liveCount++;
+    return index | (s.generation<<slotBits);
+
+}
+
+bool SessionPool::close(std::uint32_t id){
+
+    if (!find(id)) return false;
+    std::uint32_t index=id&(maxSlots-1);
+    Slot& s=slot(index);
+    s.open=false;
+    s.generation=(s.generation+1)&((1u<<(32-slotBits))-1);
+    if (s.generation==0) s.generation=1;
+    s.nextFree=freeHead;
+    freeHead=index;
+    liveCount--;
+    return true;
+
+}
+
+Game* SessionPool::find(std::uint32_t id){
+
+    std::uint32_t index=id&(maxSlots-1);
+    if (index>=slotCount) return nullptr;
+    Slot& s=slot(index);
+    return s.open && s.generation==(id>>slotBits) ? &s.game : nullptr;
+
+}
+
+std::size_t SessionPool::bytes() const{
+
+    // -- Walks every game, so it's meant for the occasional stats query, not the request path
+
+    std::size_t total=blocks.size()*(sizeof(Slot)<<blockBits);
+    for (std::uint32_t i=0;i<slotCount;i++){
+        const Game& game=slot(i).game;
+        total+=(game.getReserve().capacity()+game.getStockpile().capacity())*sizeof(Card);
+        for (int t=0;t<7;t++) total+=game.getTableau(t).capacity()*sizeof(Card);
+        for (int f=0;f<4;f++) total+=game.getFoundation(f).capacity()*sizeof(Card);
+        total+=game.getHistory().capacity()*sizeof(std::uint16_t);
+    }
+    return total;
+
+}
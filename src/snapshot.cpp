@@ -0,0 +1,87 @@
+// snapshot.cpp
+// Snapshot file writing and checking, see Snapshot.h for the layout
+
+#include "Snapshot.h"
+#include <cstdio>
+#include <cstring>
+
+bool saveSnapshot(const Game& game,const std::string& path){
+
+    // game -- Game to save 
+    // path -- File to write 
+
+    const std::vector<std::uint16_t>& history=game.getHistory();
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic,SnapshotHeader::magicBytes,sizeof(header.magic));
+    header.version=SnapshotHeader::currentVersion;
+    header.headerBytes=sizeof(SnapshotHeader);
+    header.historyCount=static_cast<std::uint32_t>(history.size());
+    header.historyCursor=static_cast<std::uint32_t>(game.getHistoryCursor());
+    header.dealSeed=game.getDealSeed();
+    header.hash=game.getHash();
+    header.state=game.getState();
+
+    // Write beside the old file and swap it in, so a crash mid save never leaves a half written snapshot 
+    std::string temporary=path+".tmp";
+    std::FILE* out=std::fopen(temporary.c_str(),"wb");
+    if (!out) return false;
+    bool written=std::fwrite(&header,sizeof(header),1,out)==1;
+    if (written && !history.empty()) written=std::fwrite(history.data(),sizeof(std::uint16_t),history.size(),out)==history.size();
+    written=std::fclose(out)==0 && written;
+    if (written){
+        std::remove(path.c_str()); // Windows won't rename over an existing file 
+        written=std::rename(temporary.c_str(),path.c_str())==0;
+    }
+    if (!written) std::remove(temporary.c_str());
+    return written;
+
+}
+
+bool loadSnapshot(Game& game,const std::string& path){
+
+    // game -- Game to load into 
+    // path -- File to read 
+
+    SnapshotView view;
+    return view.open(path) && view.restore(game);
+
+}
+
+bool SnapshotView::open(const std::string& path){
+
+    // path -- File to map 
+
+    if (!file.open(path)) return false;
+
+    bool usable=file.size()>=sizeof(SnapshotHeader);
+    if (usable){
+        const SnapshotHeader& h=header();
+        usable=std::memcmp(h.magic,SnapshotHeader::magicBytes,sizeof(h.magic))==0
+            && h.version==SnapshotHeader::currentVersion
+            && h.headerBytes==sizeof(SnapshotHeader)
+            && h.historyCursor<=h.historyCount
+            && file.size()==sizeof(SnapshotHeader)+std::uint64_t(h.historyCount)*sizeof(std::uint16_t)
+            && h.state.valid();
+    }
+    if (!usable) file.close();
+    return usable;
+
+}
+
+bool SnapshotView::restore(Game& game,bool withHistory) const{
+
+    // game -- Game to load into, untouched on failure 
+    // withHistory -- Whether to bring the undo history too, without it the history is never read from disk 
+
+    if (!file.isOpen()) return false;
+
+    Game loaded;
+    loaded.setState(state());
+    loaded.setDealSeed(header().dealSeed);
+    if (loaded.getHash()!=header().hash) return false; // The position was damaged after it was saved 
+    if (withHistory && !loaded.setHistory(history(),header().historyCount,header().historyCursor)) return false;
+    game=std::move(loaded);
+    return true;
+
+}
@@ -0,0 +1,271 @@
+// solvecache.cpp
+// Shared, memory mapped table of Solver verdicts, see SolveCache.h
+
+#include "SolveCache.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <winioctl.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::uint64_t low48=(std::uint64_t{1}<<48)-1;
+constexpr int readAttempts=64; // Before a slot a writer keeps changing counts as a miss
+
+std::uint64_t roundUpPow2(std::uint64_t value){
+    std::uint64_t result=1;
+    while (result<value) result<<=1;
+    return result;
+}
+
+}
+
+std::uint64_t SolveCache::home(std::uint64_t deal) const{
+    // -- splitmix64 finaliser, consecutive deal numbers land far apart
+    std::uint64_t z=deal+0x9E3779B97F4A7C15ull;
+    z=(z^(z>>30))*0xBF58476D1CE4E5B9ull;
+    z=(z^(z>>27))*0x94D049BB133111EBull;
+    return (z^(z>>31)) & (count-1);
+}
+
+bool SolveCache::lookup(std::uint64_t deal,CachedSolve& entry) const{
+
+    // deal  -- Deal number to look for
+    // entry -- Filled in on a hit
+
+    if (!slots) return false;
+    std::uint64_t index=home(deal);
+    for (int probe=0;probe<probeLength;probe++,index=(index+1) & (count-1)){
+        const Slot& slot=slots[index];
+        for (int attempt=0;attempt<readAttempts;attempt++){
+            std::uint64_t before=slot.words[0].load(std::memory_order_acquire);
+            std::uint32_t sequence=static_cast<std::uint32_t>(before);
+            if (sequence==0) return false; // Slots are never emptied, so the deal would have been here
+            if (sequence & 1) continue; // A writer is in the slot
+            std::uint64_t key=slot.words[1].load(std::memory_order_relaxed);
+            std::uint64_t sizes=slot.words[2].load(std::memory_order_relaxed);
+            std::uint64_t verdict=slot.words[3].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.words[0].load(std::memory_order_relaxed)!=before) continue;
+            if (key!=deal) break;
+            entry.result=static_cast<SolveResult>(verdict & 0xFF);
+            entry.nodes=sizes & low48;
+            entry.solutionLength=static_cast<std::uint16_t>(sizes>>48);
+            entry.micros=static_cast<std::uint32_t>(before>>32);
+            return true;
+        }
+    }
+    return false;
+
+}
+
+bool SolveCache::store(std::uint64_t deal,const CachedSolve& entry){
+
+    // deal  -- Deal number the verdict is for
+    // entry -- The verdict, nodes are kept to 48 bits
+
+    if (!slots) return false;
+    std::lock_guard<std::mutex> guard(writeLock);
+    if (!lockFile()) return false;
+
+    // The deal's own slot if it has one, else the first empty slot, else the one that cost least to fill
+    Slot* target=nullptr;
+    Slot* cheapest=nullptr;
+    std::uint64_t cheapestNodes=~std::uint64_t{0};
+    std::uint64_t index=home(deal);
+    for (int probe=0;probe<probeLength;probe++,index=(index+1) & (count-1)){
+        Slot& slot=slots[index];
+        if (static_cast<std::uint32_t>(slot.words[0].load(std::memory_order_relaxed))==0){
+            target=&slot;
+            break;
+        }
+        if (slot.words[1].load(std::memory_order_relaxed)==deal){
+            bool proven=static_cast<SolveResult>(slot.words[3].load(std::memory_order_relaxed) & 0xFF)!=SolveResult::OutOfBudget;
+            bool further=(slot.words[2].load(std::memory_order_relaxed) & low48)<entry.nodes;
+            if (proven || (entry.result==SolveResult::OutOfBudget && !further)){
+                unlockFile();
+                return true; // What's there already says as much
+            }
+            target=&slot;
+            break;
+        }
+        std::uint64_t nodes=slot.words[2].load(std::memory_order_relaxed) & low48;
+        if (nodes<cheapestNodes){
+            cheapestNodes=nodes;
+            cheapest=&slot;
+        }
+    }
+    if (!target) target=cheapest;
+
+    std::uint32_t sequence=static_cast<std::uint32_t>(target->words[0].load(std::memory_order_relaxed))+1;
+    if (sequence==0) sequence=1;
+    target->words[0].store(sequence,std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    target->words[1].store(deal,std::memory_order_relaxed);
+    target->words[2].store(std::min(entry.nodes,low48) | static_cast<std::uint64_t>(entry.solutionLength)<<48,std::memory_order_relaxed);
+    target->words[3].store(static_cast<std::uint64_t>(entry.result),std::memory_order_relaxed);
+    std::uint32_t stable=sequence+1==0 ? 2 : sequence+1;
+    target->words[0].store(stable | static_cast<std::uint64_t>(entry.micros)<<32,std::memory_order_release);
+
+    unlockFile();
+    return true;
+
+}
+
+#ifdef _WIN32
+
+bool SolveCache::lockFile(){
+    OVERLAPPED whole{};
+    return LockFileEx(fileHandle,LOCKFILE_EXCLUSIVE_LOCK,0,MAXDWORD,MAXDWORD,&whole)!=0;
+}
+
+void SolveCache::unlockFile(){
+    OVERLAPPED whole{};
+    UnlockFileEx(fileHandle,0,MAXDWORD,MAXDWORD,&whole);
+}
+
+bool SolveCache::mapFile(const std::string& path,std::uint64_t slotsWanted){
+
+    // path        -- Cache file, created if it doesn't exist
+    // slotsWanted -- Table size for a new file
+
+    HANDLE file=CreateFileA(path.c_str(),GENERIC_READ | GENERIC_WRITE,FILE_SHARE_READ | FILE_SHARE_WRITE,nullptr,OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,nullptr);
+    if (file==INVALID_HANDLE_VALUE) return false;
+    fileHandle=file;
+
+    // Whoever gets the lock first on an empty file lays it out, everyone else then finds it ready
+    if (!lockFile()) return false;
+    LARGE_INTEGER fileSize;
+    bool ok=GetFileSizeEx(file,&fileSize)!=0;
+    if (ok && fileSize.QuadPart==0){
+        SolveCacheHeader header{};
+        std::memcpy(header.magic,magicBytes,sizeof(header.magic));
+        header.version=currentVersion;
+        header.slotBytes=sizeof(Slot);
+        header.slotCount=roundUpPow2(std::max<std::uint64_t>(slotsWanted,probeLength));
+        DWORD sparse=0;
+        DeviceIoControl(file,FSCTL_SET_SPARSE,nullptr,0,nullptr,0,&sparse,nullptr); // Best effort
+        fileSize.QuadPart=static_cast<LONGLONG>(sizeof(header)+header.slotCount*sizeof(Slot));
+        DWORD written=0;
+        ok=SetFilePointerEx(file,fileSize,nullptr,FILE_BEGIN) && SetEndOfFile(file)
+            && SetFilePointer(file,0,nullptr,FILE_BEGIN)!=INVALID_SET_FILE_POINTER
+            && WriteFile(file,&header,sizeof(header),&written,nullptr) && written==sizeof(header);
+    }
+    unlockFile();
+    if (!ok || fileSize.QuadPart<static_cast<LONGLONG>(sizeof(SolveCacheHeader))) return false;
+
+    mappingHandle=CreateFileMappingA(file,nullptr,PAGE_READWRITE,0,0,nullptr);
+    if (!mappingHandle) return false;
+    void* view=MapViewOfFile(mappingHandle,FILE_MAP_ALL_ACCESS,0,0,0);
+    if (!view) return false;
+    bytes=static_cast<unsigned char*>(view);
+    length=static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void SolveCache::unmapFile(){
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    fileHandle=nullptr;
+    mappingHandle=nullptr;
+}
+
+#else
+
+bool SolveCache::lockFile(){
+    while (flock(fd,LOCK_EX)!=0){
+        if (errno!=EINTR) return false;
+    }
+    return true;
+}
+
+void SolveCache::unlockFile(){
+    flock(fd,LOCK_UN);
+}
+
+bool SolveCache::mapFile(const std::string& path,std::uint64_t slotsWanted){
+
+    // path        -- Cache file, created if it doesn't exist
+    // slotsWanted -- Table size for a new file
+
+    fd=::open(path.c_str(),O_RDWR | O_CREAT,0644);
+    if (fd<0) return false;
+
+    // Whoever gets the lock first on an empty file lays it out, everyone else then finds it ready
+    if (!lockFile()) return false;
+    struct stat info;
+    bool ok=fstat(fd,&info)==0;
+    if (ok && info.st_size==0){
+        SolveCacheHeader header{};
+        std::memcpy(header.magic,magicBytes,sizeof(header.magic));
+        header.version=currentVersion;
+        header.slotBytes=sizeof(Slot);
+        header.slotCount=roundUpPow2(std::max<std::uint64_t>(slotsWanted,probeLength));
+        info.st_size=static_cast<off_t>(sizeof(header)+header.slotCount*sizeof(Slot));
+        ok=ftruncate(fd,info.st_size)==0 && pwrite(fd,&header,sizeof(header),0)==static_cast<ssize_t>(sizeof(header)); // The hole reads back as empty slots
+    }
+    unlockFile();
+    if (!ok || info.st_size<static_cast<off_t>(sizeof(SolveCacheHeader))) return false;
+
+    void* view=mmap(nullptr,static_cast<std::size_t>(info.st_size),PROT_READ | PROT_WRITE,MAP_SHARED,fd,0);
+    if (view==MAP_FAILED) return false;
+    bytes=static_cast<unsigned char*>(view);
+    length=static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+void SolveCache::unmapFile(){
+    if (bytes) munmap(bytes,length);
+    if (fd>=0) ::close(fd); // Kept open while mapped, writers lock it
+    fd=-1;
+}
+
+#endif
+
+bool SolveCache::open(const std::string& path,std::uint64_t slotsWanted){
+
+    // path        -- Cache file, created if it doesn't exist
+    // slotsWanted -- Table size for a new file, an existing one keeps its own
+
+    close();
+    if (!mapFile(path,slotsWanted)){
+        close();
+        return false;
+    }
+
+    // Check it is a cache this build can read before trusting its slot count
+    SolveCacheHeader header;
+    std::memcpy(&header,bytes,sizeof(header));
+    if (std::memcmp(header.magic,magicBytes,sizeof(header.magic))!=0 || header.version!=currentVersion
+        || header.slotBytes!=sizeof(Slot) || header.slotCount<probeLength || (header.slotCount & (header.slotCount-1))!=0
+        || header.slotCount>(length-sizeof(header))/sizeof(Slot)){
+        close();
+        return false;
+    }
+    count=header.slotCount;
+    slots=reinterpret_cast<Slot*>(bytes+sizeof(header));
+    return true;
+
+}
+
+void SolveCache::close(){
+    unmapFile();
+    bytes=nullptr;
+    length=0;
+    slots=nullptr;
+    count=0;
+}
@@ -0,0 +1,289 @@
+// solver.cpp
+// Depth first Klondike solver, see Solver.h
+
+#include "Solver.h"
+#include "ParallelSolver.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+double now(){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int foundationCount(const Game& game){
+    int n=0;
+    for (int f=0;f<4;f++) n+=static_cast<int>(game.getFoundation(f).size());
+    return n;
+}
+
+}
+
+const char* solveResultName(SolveResult result){
+    switch (result){
+        case SolveResult::Solved: return "solved";
+        case SolveResult::Unsolvable: return "unsolvable";
+        default: return "out-of-budget";
+    }
+}
+
+Solver::Solver(const SolverConfig& config) : config(config), table(config.tableBytes) {}
+
+int Solver::generateSteps(const Game& game,std::vector<Step>& steps){
+
+    // game -- The position to generate for 
+    // steps -- Steps are appended here, already ordered 
+
+    const std::size_t first=steps.size();
+    bool emptyTableauSeen=false, emptyFoundationSeen=false;
+
+    // Returns true if the step was forced, in which case it replaces everything added so far
+    auto add=[&](Step step){
+        const Move& move=step.move;
+        const Card& card=move.getCard();
+        Location from=move.getStartingPosition();
+
+        if (move.getDestination()==Location::Foundation){
+            if (game.getFoundation(move.getPile()).empty()){ // Every empty foundation is the same, only keep the first 
+                if (emptyFoundationSeen) return false;
+                emptyFoundationSeen=true;
+            }
+            if (step.length()==1 && game.safeToFoundation(card)){ // Nothing can be lost by playing it now, so it's forced
+                steps.resize(first);
+                steps.push_back(step);
+                return true;
+            }
+            step.score=900;
+        } else {
+            if (game.getTableau(move.getPile()).empty()){
+                if (from==Location::Tableau && card.getTableauIndex()==0) return false; // King from one empty column to another 
+                if (emptyTableauSeen && from!=Location::Stockpile) return false; // Every empty column is the same, only keep the first 
+                emptyTableauSeen=true;
+            }
+            if (from==Location::Tableau){
+                int index=card.getTableauIndex();
+                const std::vector<Card>& pile=game.getTableau(move.getStartingPile());
+                if (index>0 && !pile[index-1].getFaceUp()){
+                    step.score=800+index; // Turns a card over, the more hidden cards beneath the better 
+                } else if (index==0){
+                    step.score=400; // Empties a column 
+                } else {
+                    // Splits a run, only worth it to free the card beneath for a foundation 
+                    bool frees=false;
+                    for (int f=0;f<4 && !frees;f++) frees=game.canMoveToFoundation(pile[index-1],f);
+                    if (!frees) return false;
+                    step.score=300;
+                }
+            } else if (from==Location::Stockpile){
+                step.score=600;
+            } else {
+                step.score=100; // Foundation back down 
+            }
+        }
+        step.score-=step.length(); // Prefer stock cards that need fewer deals 
+        steps.push_back(step);
+        return false;
+    };
+
+    // Tableau and foundation moves, stock actions are replaced by the stock steps below
+    Game::MoveBuffer moves;
+    int count=game.generateMoves(moves);
+    for (int i=0;i<count;i++){
+        Location from=moves[i].getStartingPosition();
+        if (from==Location::Reserve || from==Location::Stockpile) continue;
+        Step step;
+        step.move=moves[i];
+        if (add(step)) return 1;
+    }
+
+    // Every card in the stock, in the order dealing would bring it to the top: the current top, then the reserve
+    // top down, then after a recycle the stockpile from the bottom
+    const std::vector<Card>& reserve=game.getReserve();
+    const std::vector<Card>& stockpile=game.getStockpile();
+    int reserveSize=static_cast<int>(reserve.size());
+    int stockSize=static_cast<int>(stockpile.size());
+    for (int k=0;k<reserveSize+stockSize;k++){
+        Step step;
+        const Card* card;
+        if (k==0 && stockSize>0){
+            card=&stockpile.back();
+        } else if (k<=reserveSize && (k>0 || stockSize==0)){
+            int draws=stockSize>0 ? k : k+1;
+            if (draws>reserveSize) continue;
+            card=&reserve[reserveSize-draws];
+            step.drawsBefore=static_cast<std::uint8_t>(draws);
+        } else {
+            int index=k-reserveSize-1; // Stockpile card from the bottom 
+            if (index<0 || index>=stockSize-1) continue;
+            card=&stockpile[index];
+            step.drawsBefore=static_cast<std::uint8_t>(reserveSize);
+            step.recycle=true;
+            step.drawsAfter=static_cast<std::uint8_t>(index+1);
+        }
+
+        for (int f=0;f<4;f++){
+            if (!game.canMoveToFoundation(*card,f)) continue;
+            step.move=Move(*card,Location::Stockpile,Location::Foundation,f,-1);
+            if (add(step)) return 1;
+        }
+        for (int t=0;t<7;t++){
+            if (!game.canStackOnTableau(*card,t)) continue;
+            step.move=Move(*card,Location::Stockpile,Location::Tableau,t,-1);
+            if (add(step)) return 1;
+        }
+    }
+
+    // Insertion sort, step lists are short 
+    for (std::size_t i=first+1;i<steps.size();i++){
+        Step step=steps[i];
+        std::size_t j=i;
+        while (j>first && steps[j-1].score<step.score){
+            steps[j]=steps[j-1];
+            j--;
+        }
+        steps[j]=step;
+    }
+    return static_cast<int>(steps.size()-first);
+
+}
+
+void Solver::play(const Step& step){
+
+    // -- Deals ( and recycles ) until the step's card is on top of the stockpile, then makes the move 
+
+    for (int i=0;i<step.drawsBefore;i++){
+        path.push_back(Move(game.getReserve().back(),Location::Reserve,Location::Stockpile,-1,-1));
+        game.dealFromReserve();
+    }
+    if (step.recycle){
+        path.push_back(Move(game.getStockpile().back(),Location::Stockpile,Location::Reserve,-1,-1));
+        game.resetStockpile();
+    }
+    for (int i=0;i<step.drawsAfter;i++){
+        path.push_back(Move(game.getReserve().back(),Location::Reserve,Location::Stockpile,-1,-1));
+        game.dealFromReserve();
+    }
+    path.push_back(step.move);
+    game.applyMove(step.move);
+
+}
+
+void Solver::takeBack(const Step& step){
+    for (int i=0;i<step.length();i++){
+        game.undo();
+        path.pop_back();
+    }
+}
+
+bool Solver::outOfBudget(){
+
+    // -- Checks the node budget every node and the clock every few thousand nodes 
+
+    if (stopped) return true;
+    if (parallel){ // The parallel search keeps the budget, nodes are handed over in batches 
+        if (++unchargedNodes>=1024){
+            parallel->chargeNodes(unchargedNodes);
+            unchargedNodes=0;
+        }
+        stopped=parallel->stopRequested();
+        return stopped;
+    }
+    if (config.maxNodes>0 && outcome.stats.nodes>=config.maxNodes) stopped=true;
+    if (config.maxSeconds>0.0 && outcome.stats.nodes>=nextClockCheck){
+        nextClockCheck=outcome.stats.nodes+4096;
+        if (now()-startTime>=config.maxSeconds) stopped=true;
+    }
+    return stopped;
+
+}
+
+bool Solver::search(int depth){
+
+    // -- Searches every line from the current position, returns true once the search should stop
+    // depth -- Moves played from the root 
+
+    if (game.getWon()){
+        if (parallel){
+            parallel->report(path);
+            return true;
+        }
+        if (bestLength==0 || path.size()<bestLength){
+            bestLength=path.size();
+            outcome.solution=path;
+            outcome.result=SolveResult::Solved;
+        }
+        return !config.findShortest;
+    }
+
+    if (outOfBudget()) return true;
+    outcome.stats.nodes++;
+
+    // Every card left needs at least one more move 
+    if (bestLength!=0 && path.size()+(52-foundationCount(game))>=bestLength) return false;
+
+    if (depth>=config.maxDepth){
+        truncated=true;
+        return false;
+    }
+    // Looking for any win, a position seen once never needs searching again. Looking for the shortest, it does if reached in
+    // fewer real moves, which is path length, not depth: one step can stand for many deals and a recycle
+    if (config.useTable){
+        std::uint64_t hash=game.getHash();
+        int visitDepth=config.findShortest ? static_cast<int>(path.size()) : 0;
+        if (!(parallel ? parallel->table.visit(hash,visitDepth) : table.visit(hash,visitDepth))) return false;
+    }
+
+    std::size_t frame=steps.size();
+    int count=generateSteps(game,steps);
+
+    for (int i=0;i<count;i++){
+        if (parallel && i+1<count && parallel->wantsWork(depth)){
+            // Another thread is idle, hand it the rest of this node's steps 
+            parallel->split(*this,frame+i+1,frame+count,depth+1);
+            count=i+1;
+        }
+        Step step=steps[frame+i];
+        play(step);
+        bool stop=search(depth+1);
+        takeBack(step);
+        if (stop){
+            steps.resize(frame);
+            return true;
+        }
+    }
+    steps.resize(frame);
+    return false;
+
+}
+
+SolveOutcome Solver::solve(const Game& start){
+
+    // start -- The position to solve from 
+
+    game=start;
+    path.clear();
+    steps.clear();
+    table.clear();
+    outcome=SolveOutcome();
+    bestLength=0;
+    stopped=false;
+    truncated=false;
+    nextClockCheck=0;
+    startTime=now();
+
+    search(0);
+
+    outcome.stats.seconds=now()-startTime;
+    outcome.stats.tableBytes=table.bytes();
+    outcome.stats.tableEntries=table.entries();
+
+    bool exhausted=!stopped && !truncated;
+    if (outcome.result==SolveResult::Solved){
+        outcome.shortestProven=config.findShortest && exhausted;
+    } else if (exhausted){
+        outcome.result=SolveResult::Unsolvable;
+    }
+    return outcome;
+
+}
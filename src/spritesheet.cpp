@@ -2,6 +2,7 @@
 // Handles the spritesheet, and sprite textures
 
 #include "Spritesheet.h"
+#include "Atlas.h"
 #include "Graphics.h"
 
 // -- Loads the Spritesheet 
@@ -9,12 +10,66 @@ bool Spritesheet::loadFromFile(const std::string& path) {
 
     // path --The file path for the texture 
 
-    if (!texture.loadFromFile(path)) return false;
+    texture=resources.texture(path);
+    if (!texture) return false;
 
-    // Initialise card width and height, note the sprite sheet is 13 cols by 6 rows
-    sf::Vector2u texSize = texture.getSize();
-    _cardWidth  = static_cast<int>(texSize.x / 13);
-    _cardHeight = static_cast<int>(texSize.y / 6);
+    // Frame table, so drawing a card never builds a rectangle 
+    frames=sheetLayout(texture->getSize());
+    _cardWidth  = frames[0].size.x;
+    _cardHeight = frames[0].size.y;
+    return true;
+
+}
+
+// -- Where each frame is on Spritesheet.png, note the sprite sheet is 13 cols by 6 rows 
+std::array<sf::IntRect,Spritesheet::frameCount> Spritesheet::sheetLayout(sf::Vector2u sheetSize){
+
+    // sheetSize -- Size of the whole sheet in pixels 
+
+    int width  = static_cast<int>(sheetSize.x / 13);
+    int height = static_cast<int>(sheetSize.y / 6);
+    std::array<sf::IntRect,frameCount> layout;
+    auto cell=[&](int col,int row){ return sf::IntRect({col*width,row*height},{width,height}); };
+    for (int suit=0;suit<4;suit++){
+        for (int value=0;value<13;value++) layout[value+suit*13]=cell(value,suit); // Faces are a row per suit, Ace to King 
+    }
+    for (int i=0;i<3;i++) layout[backFrame0+i]=cell(3+i,5); // Backs are on row 5, cols 3 to 5 
+    layout[resetFrame]=cell(10,4);
+    return layout;
+
+}
+
+// -- Loads the atlas made by solitaire-atlas, the sheet and both buttons in one texture 
+bool Spritesheet::loadAtlas(const std::string& image,const std::string& table){
+
+    // image -- The packed texture, i.e. "assets/atlas.png" 
+    // table -- Where everything is on it, i.e. "assets/atlas.bin" 
+
+    AtlasTable loaded;
+    if (!loaded.load(table)) return false;
+    const sf::Texture* packed=resources.texture(image);
+    if (!packed || packed->getSize()!=sf::Vector2u(loaded.getWidth(),loaded.getHeight())) return false; // Not the image the table was built with 
+
+    auto rect=[](const AtlasEntry& e){ return sf::IntRect({e.x,e.y},{e.width,e.height}); };
+    std::array<sf::IntRect,frameCount> packedFrames;
+    for (int frame=0;frame<frameCount;frame++){
+        const AtlasEntry* entry=loaded.find(AtlasKey::frame(frame));
+        if (!entry) return false;
+        packedFrames[frame]=rect(*entry);
+    }
+    const AtlasEntry* undoEntry=loaded.find(AtlasKey::undo);
+    const AtlasEntry* newDealEntry=loaded.find(AtlasKey::newDeal);
+    const AtlasEntry* solidEntry=loaded.find(AtlasKey::solid);
+    if (!undoEntry || !newDealEntry || !solidEntry) return false;
+
+    texture=undo=newDeal=packed;
+    frames=packedFrames;
+    _cardWidth  = frames[0].size.x;
+    _cardHeight = frames[0].size.y;
+    undoRect=rect(*undoEntry);
+    newDealRect=rect(*newDealEntry);
+    solid={ solidEntry->x+solidEntry->width*0.5f, solidEntry->y+solidEntry->height*0.5f }; // The middle, well clear of its neighbours 
+    atlasLoaded=true;
     return true;
 
 }
@@ -23,7 +78,9 @@ bool Spritesheet::loadFromFile(const std::string& path) {
 bool Spritesheet::loadUndo(const std::string& path){
 
     // path - The file path for the texture 
-    if (!undo.loadFromFile(path)) return false;
+    undo=resources.texture(path);
+    if (!undo) return false;
+    undoRect=sf::IntRect({0,0},sf::Vector2i(undo->getSize()));
     return true;
 }
 
@@ -31,62 +88,17 @@ bool Spritesheet::loadUndo(const std::string& path){
 bool Spritesheet::loadNewDeal(const std::string& path){
 
     // path - The file path for the texture 
-    if (!newDeal.loadFromFile(path)) return false;
+    newDeal=resources.texture(path);
+    if (!newDeal) return false;
+    newDealRect=sf::IntRect({0,0},sf::Vector2i(newDeal->getSize()));
     return true;
 }
 
-// -- Returns a sprite for a card on column col and row row of the Spritesheet
-sf::Sprite Spritesheet::getCardSprite(int col, int row) const {
-
-    // col - The column we want to isolate 
-    // row - The row we want to isolate 
-
-    sf::IntRect rect( // Isolate card from spritesheet 
-        {col * _cardWidth,
-        row * _cardHeight},
-       { _cardWidth,
-        _cardHeight}
-    );
-
-    sf::Sprite sprite{texture, rect};
-    return sprite;
-
-}
-
-
-// -- Back card animation 
-int start=3; // Iterate from 3 to 5 to animate the back card
-sf::Sprite Spritesheet::makeBackSprite() {
+// -- Back card animation, returns the frame of the back to show 
+int Spritesheet::backFrame() {
     if (backClock.getElapsedTime() >= backCardDelay){ // We've passed the delay 
-        start++; // Increment the back card sprite 
-        if (start>5){ 
-            start=3;
-        }
+        backIndex=(backIndex+1)%3; // Move on to the next back 
         backClock.restart(); // Reset the clock
     }
-    return Spritesheet::getCardSprite(start,5); // Set the back card sprite 
+    return backFrame0+backIndex;
 }
-
-// -- Creates the reset button sprite, which is on col 10 row 4
-sf::Sprite Spritesheet::makeResetSprite() const {
-    return Spritesheet::getCardSprite(10,4);
-}
-
-// -- Creates a card sprite for a Card object 
-sf::Sprite Spritesheet::makeCardSprite(const Card& card) const {
-
-    // card - The card object we want to create a sprite for 
-    int col = static_cast<int>(card.getValue()); // Enums established to fit the Spritesheet 
-    int row = static_cast<int>(card.getSuit());  
-
-    sf::IntRect rect(
-        {col * _cardWidth,
-        row * _cardHeight},
-       { _cardWidth,
-        _cardHeight}
-    );
-
-    sf::Sprite sprite{texture, rect};
-    return sprite;
-
-}
\ No newline at end of file
@@ -0,0 +1,115 @@
+// threadpool.cpp
+// Work stealing thread pool, see ThreadPool.h
+
+#include "ThreadPool.h"
+
+namespace {
+thread_local const ThreadPool* workerPool=nullptr; // Pool the current thread works for, nullptr if none 
+thread_local int workerIndex=-1; // Which of workerPool's workers it is 
+}
+
+ThreadPool::ThreadPool(int threadCount){
+
+    if (threadCount<=0) threadCount=static_cast<int>(std::thread::hardware_concurrency());
+    if (threadCount<=0) threadCount=1;
+
+    for (int i=0;i<threadCount;i++) queues.push_back(std::make_unique<Queue>());
+    for (int i=0;i<threadCount;i++) threads.emplace_back([this,i]{ run(i); });
+
+}
+
+ThreadPool::~ThreadPool(){
+    wait();
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping=true;
+    }
+    wake.notify_all();
+    for (std::thread& t : threads) t.join();
+}
+
+int ThreadPool::currentWorker() const{
+    return workerPool==this ? workerIndex : -1; // A worker of another pool is an outside thread to this one 
+}
+
+void ThreadPool::submit(std::function<void()> task){
+
+    // task -- The work to run 
+
+    int self=currentWorker();
+    int target=self>=0 ? self : static_cast<int>(nextQueue++%queues.size());
+    pending++;
+    {
+        std::lock_guard<std::mutex> guard(queues[target]->lock);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    {
+        // Taken so a worker between checking for work and sleeping can't miss the wake up 
+        std::lock_guard<std::mutex> guard(sleepLock);
+        queued++;
+    }
+    wake.notify_one();
+
+}
+
+void ThreadPool::wait(){
+    std::unique_lock<std::mutex> guard(sleepLock);
+    done.wait(guard,[this]{ return pending.load()==0; });
+}
+
+bool ThreadPool::take(int self,std::function<void()>& task){
+
+    // self -- The worker looking for a task 
+    // task -- Set to the task taken 
+
+    {
+        Queue& own=*queues[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()){
+            task=std::move(own.tasks.back()); // Newest first, it shares the most with what this worker just did 
+            own.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    int count=static_cast<int>(queues.size());
+    for (int i=1;i<count;i++){
+        Queue& victim=*queues[(self+i)%count];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()){
+            task=std::move(victim.tasks.front()); // Oldest first, the biggest piece of work 
+            victim.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+
+}
+
+void ThreadPool::run(int self){
+
+    workerPool=this;
+    workerIndex=self;
+    std::function<void()> task;
+
+    while (true){
+        if (take(self,task)){
+            task();
+            task=nullptr;
+            if (--pending==0){
+                std::lock_guard<std::mutex> guard(sleepLock);
+                done.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(sleepLock);
+        idle++;
+        wake.wait(guard,[this]{ return stopping || queued.load()>0; });
+        idle--;
+        if (stopping && queued.load()==0) return;
+    }
+
+}
@@ -0,0 +1,156 @@
+// transpositiontable.cpp
+// Open addressing table of searched positions, see TranspositionTable.h
+
+#include "TranspositionTable.h"
+#include <algorithm>
+
+namespace {
+
+constexpr int depthBits=TranspositionTable::depthBits;
+constexpr std::uint64_t occupied=1ull<<63; // Keeps keys non zero so 0 can mean empty, far above any bit an index uses
+
+// -- A position's key, its hash with the depth bits cleared and marked occupied 
+std::uint64_t keyOf(std::uint64_t hash){
+    return (hash & ~((1ull<<depthBits)-1)) | occupied;
+}
+
+// -- First slot of the probe run, from hash bits only, so a hash, its key and an entry all land in the same place and
+// entries can be re-inserted when growing 
+std::uint64_t homeSlot(std::uint64_t hashOrEntry,std::uint64_t mask){
+    return (hashOrEntry>>depthBits) & mask;
+}
+
+}
+
+TranspositionTable::TranspositionTable(std::size_t maxBytes){
+
+    // Round the budget down to a power of two number of slots, starting the table at 1/64th of it ( at least 1024 slots )
+    maxSlots=1024;
+    while (maxSlots*2*sizeof(std::uint64_t)<=maxBytes) maxSlots*=2;
+    slots.assign(maxSlots>=65536 ? maxSlots/64 : maxSlots,0);
+
+}
+
+void TranspositionTable::clear(){
+    std::fill(slots.begin(),slots.end(),0);
+    used=0;
+    evicted=0;
+}
+
+bool TranspositionTable::visit(std::uint64_t hash,int depth){
+
+    // hash -- The position hash
+    // depth -- How many moves from the root the position was reached at
+
+    if (depth>maxDepth) depth=maxDepth;
+    std::uint64_t key=keyOf(hash);
+    std::uint64_t mask=slots.size()-1;
+    std::uint64_t start=homeSlot(hash,mask);
+
+    for (int i=0;i<probeLength;i++){
+        std::uint64_t& slot=slots[(start+i)&mask];
+        if (slot==0) break;
+        if ((slot & ~depthMask)==key){
+            if (static_cast<int>(slot & depthMask)<=depth) return false; // Already searched from here with at least as many moves left 
+            slot=key | static_cast<std::uint64_t>(depth);
+            return true;
+        }
+    }
+
+    if (used*2>=slots.size() && slots.size()<maxSlots) grow();
+    insert(key | static_cast<std::uint64_t>(depth));
+    return true;
+
+}
+
+void TranspositionTable::insert(std::uint64_t entry){
+
+    // -- Places an entry in the first empty slot of its probe run, or over the deepest entry in the run if it's full
+
+    std::uint64_t mask=slots.size()-1;
+    std::uint64_t start=homeSlot(entry,mask);
+    std::uint64_t* victim=nullptr;
+    for (int i=0;i<probeLength;i++){
+        std::uint64_t& slot=slots[(start+i)&mask];
+        if (slot==0){
+            slot=entry;
+            used++;
+            return;
+        }
+        if (victim==nullptr || (slot & depthMask)>(*victim & depthMask)) victim=&slot;
+    }
+    *victim=entry;
+    evicted++;
+
+}
+
+void TranspositionTable::grow(){
+
+    // -- Doubles the table and re-inserts every entry 
+
+    std::vector<std::uint64_t> old(slots.size()*2,0);
+    old.swap(slots);
+    used=0;
+    for (std::uint64_t entry : old){
+        if (entry!=0) insert(entry);
+    }
+
+}
+
+// -------- Concurrent table 
+
+ConcurrentTranspositionTable::ConcurrentTranspositionTable(std::size_t maxBytes){
+
+    slotCount=1024;
+    while (slotCount*2*sizeof(std::uint64_t)<=maxBytes) slotCount*=2;
+    slots.reset(new std::atomic<std::uint64_t>[slotCount]);
+    clear();
+
+}
+
+void ConcurrentTranspositionTable::clear(){
+    for (std::size_t i=0;i<slotCount;i++) slots[i].store(0,std::memory_order_relaxed);
+    used.store(0,std::memory_order_relaxed);
+}
+
+bool ConcurrentTranspositionTable::visit(std::uint64_t hash,int depth){
+
+    // hash -- The position hash
+    // depth -- How many moves from the root the position was reached at
+
+    if (depth>TranspositionTable::maxDepth) depth=TranspositionTable::maxDepth;
+    std::uint64_t key=keyOf(hash);
+    std::uint64_t entry=key | static_cast<std::uint64_t>(depth);
+    std::uint64_t mask=slotCount-1;
+    std::uint64_t start=homeSlot(hash,mask);
+    std::atomic<std::uint64_t>* victim=nullptr;
+    std::uint64_t victimDepth=0;
+
+    for (int i=0;i<probeLength;i++){
+        std::atomic<std::uint64_t>& slot=slots[(start+i)&mask];
+        std::uint64_t current=slot.load(std::memory_order_relaxed);
+        while (true){
+            if (current==0){
+                if (slot.compare_exchange_weak(current,entry,std::memory_order_relaxed)){
+                    used.fetch_add(1,std::memory_order_relaxed);
+                    return true;
+                }
+                continue; // Lost the race for the empty slot, look at what won it 
+            }
+            if ((current & ~depthMask)==key){
+                if ((current & depthMask)<=static_cast<std::uint64_t>(depth)) return false;
+                if (slot.compare_exchange_weak(current,entry,std::memory_order_relaxed)) return true;
+                continue;
+            }
+            break;
+        }
+        if (victim==nullptr || (current & depthMask)>victimDepth){
+            victim=&slot;
+            victimDepth=current & depthMask;
+        }
+    }
+
+    victim->store(entry,std::memory_order_relaxed); // Probe run is full, replace its deepest entry 
+    return true;
+
+}
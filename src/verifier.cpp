@@ -0,0 +1,96 @@
+// verifier.cpp
+// Replays submitted solutions, see Verifier.h
+
+#include "Verifier.h"
+#include "Notation.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr std::size_t linesPerTask=512; // Enough that queueing a task is noise next to running it
+
+bool isSpace(char c){
+    return c==' ' || c=='\t' || c=='\r';
+}
+
+}
+
+const char* verifyResultName(VerifyResult result){
+    switch (result){
+        case VerifyResult::Won: return "won";
+        case VerifyResult::NotWon: return "not won";
+        case VerifyResult::Illegal: return "illegal move";
+        case VerifyResult::Unreadable: return "unreadable move";
+        case VerifyResult::NoDeal: return "no deal number";
+        default: return "skipped";
+    }
+}
+
+Verdict verifySubmission(std::string_view line,Game& game){
+
+    // line -- One submission, without its newline
+    // game -- Where to replay it, left at the position the submission stopped in
+
+    Verdict verdict;
+    std::size_t pos=0;
+    while (pos<line.size() && isSpace(line[pos])) pos++;
+    if (pos==line.size() || line[pos]=='#'){
+        verdict.result=VerifyResult::Skipped;
+        return verdict;
+    }
+
+    std::uint64_t seed=0;
+    std::size_t digits=pos;
+    bool overflow=false; // Past the largest deal number, wrapping would replay some other deal 
+    while (pos<line.size() && line[pos]>='0' && line[pos]<='9'){
+        std::uint64_t digit=static_cast<std::uint64_t>(line[pos++]-'0');
+        if (seed>(std::numeric_limits<std::uint64_t>::max()-digit)/10) overflow=true;
+        seed=seed*10+digit;
+    }
+    verdict.offset=static_cast<std::uint32_t>(digits);
+    verdict.length=static_cast<std::uint32_t>(pos-digits);
+    if (pos==digits || overflow || (pos<line.size() && !isSpace(line[pos]))) return verdict;
+    game.dealNewGame(seed);
+
+    Move move;
+    while (true){
+        while (pos<line.size() && isSpace(line[pos])) pos++;
+        if (pos==line.size()) break;
+        std::size_t start=pos;
+        while (pos<line.size() && !isSpace(line[pos])) pos++;
+        verdict.offset=static_cast<std::uint32_t>(start);
+        verdict.length=static_cast<std::uint32_t>(pos-start);
+        if (!parseMove(game,line.substr(start,pos-start),move)){
+            verdict.result=VerifyResult::Unreadable;
+            return verdict;
+        }
+        if (!game.applyMove(move)){
+            verdict.result=VerifyResult::Illegal;
+            return verdict;
+        }
+        verdict.moves++;
+    }
+
+    verdict.offset=static_cast<std::uint32_t>(line.size());
+    verdict.length=0;
+    verdict.result=game.getWon() ? VerifyResult::Won : VerifyResult::NotWon;
+    return verdict;
+
+}
+
+void verifyBatch(ThreadPool& pool,const std::vector<std::string_view>& lines,std::vector<Verdict>& verdicts){
+
+    // -- Splits lines into tasks of linesPerTask, each writes only its own verdicts so nothing is shared
+
+    verdicts.resize(lines.size());
+    for (std::size_t first=0;first<lines.size();first+=linesPerTask){
+        pool.submit([&,first]{
+            Game game;
+            std::size_t last=std::min(lines.size(),first+linesPerTask);
+            for (std::size_t i=first;i<last;i++) verdicts[i]=verifySubmission(lines[i],game);
+        });
+    }
+    pool.wait();
+
+}
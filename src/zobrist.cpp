@@ -0,0 +1,30 @@
+// zobrist.cpp
+// Builds the Zobrist key table 
+
+#include "Zobrist.h"
+#include "Random.h"
+
+namespace Zobrist{
+
+namespace {
+
+Keys table; // 130 KB, kept out of the stack 
+
+bool build(){
+    Xoshiro256 rng(0x5A0B1257ull); // Any fixed seed works, changing it changes every hash 
+    for (auto& card : table.place)
+        for (auto& pile : card)
+            for (std::uint64_t& key : pile) key=rng();
+    for (std::uint64_t& key : table.faceUp) key=rng();
+    return true;
+}
+
+}
+
+const Keys& keys(){
+    static const bool built=build(); // Thread safe, and runs before any other file's statics can ask 
+    (void)built;
+    return table;
+}
+
+}
@@ -0,0 +1,297 @@
+// analyze.cpp
+// solitaire-analyze, deals and solves every game in a range of deal numbers and streams one result per deal
+//
+// Usage: solitaire-analyze --from N --to M [options]
+//   --threads T        Worker threads, default one per core
+//   --nodes X          Per deal node budget, default 1000000
+//   --seconds S        Per deal time budget, default 10
+//   --table-mb MB      Per thread transposition table budget, default 64
+//   --out FILE         Results file, default analysis.csv
+//   --format csv|bin   Output format, default csv. bin writes the fixed 24 byte AnalysisRecord below after an 8 byte header
+//   --checkpoint FILE  Checkpoint file, default <out>.ckpt
+//   --cache FILE       Solve cache ( see SolveCache.h ) to answer from and add to, shared with other runs at once
+//
+// Results are written in deal order. The checkpoint records the next deal to write and how long the output was at that
+// point, so rerunning the same command after an interruption truncates any partial tail and carries on from there. It
+// also records --from, --to and --format, and a rerun with different ones is refused rather than appended to the
+// wrong file. Workers never run more than a window of deals ahead of the next one to write, so a slow deal can't make
+// the results waiting behind it grow without bound.
+
+#include "Game.h"
+#include "SolveCache.h"
+#include "Solver.h"
+#include "TimingStats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct AnalysisRecord{ // One solved deal, also the on disk layout of --format bin ( little endian )
+    std::uint64_t seed;
+    std::uint64_t nodes;
+    std::uint32_t micros; // Solve time 
+    std::uint16_t solutionLength; // Moves, 0 unless solved 
+    std::uint8_t result; // SolveResult 
+    std::uint8_t reserved;
+};
+static_assert(sizeof(AnalysisRecord)==24, "AnalysisRecord is a file format");
+
+const char binaryMagic[8]={'K','S','A','R','v','1',0,0};
+constexpr std::uint64_t minAheadWindow=4096; // Deals workers may run ahead of the writer, at least 
+
+struct Options{
+    std::uint64_t from=1;
+    std::uint64_t to=0;
+    int threads=0;
+    SolverConfig solver;
+    std::string out="analysis.csv";
+    std::string checkpoint;
+    std::string cache;
+    bool binary=false;
+};
+
+struct Checkpoint{
+    std::uint64_t nextSeed=0; // First deal not yet written 
+    std::uint64_t outputBytes=0; // Output length once every deal before nextSeed was written 
+    std::uint64_t from=0; // The run it belongs to 
+    std::uint64_t to=0;
+    std::string format;
+};
+
+bool readCheckpoint(const std::string& path,Checkpoint& checkpoint){
+    std::ifstream in(path);
+    return static_cast<bool>(in >> checkpoint.nextSeed >> checkpoint.outputBytes >> checkpoint.from >> checkpoint.to >> checkpoint.format);
+}
+
+// -- Writes the checkpoint to a temporary file first, then renames it over the old one, so it is never half written
+void writeCheckpoint(const std::string& path,const Checkpoint& checkpoint){
+    std::string temp=path+".tmp";
+    {
+        std::ofstream out(temp,std::ios::trunc);
+        out << checkpoint.nextSeed << " " << checkpoint.outputBytes << " " << checkpoint.from << " " << checkpoint.to << " "
+            << checkpoint.format << "\n";
+    }
+    std::filesystem::rename(temp,path);
+}
+
+void writeRecord(std::ofstream& out,const AnalysisRecord& record,bool binary){
+    if (binary){
+        out.write(reinterpret_cast<const char*>(&record),sizeof(record));
+        return;
+    }
+    out << record.seed << "," << solveResultName(static_cast<SolveResult>(record.result)) << "," << record.nodes << ","
+        << record.solutionLength << "," << record.micros/1e6 << "\n";
+}
+
+bool parseOptions(int argc,char** argv,Options& options){
+
+    for (int i=1;i<argc;i++){
+        std::string arg=argv[i];
+        if (i+1>=argc) return false;
+        std::string value=argv[++i];
+        if (arg=="--from") options.from=std::strtoull(value.c_str(),nullptr,10);
+        else if (arg=="--to") options.to=std::strtoull(value.c_str(),nullptr,10);
+        else if (arg=="--threads") options.threads=std::atoi(value.c_str());
+        else if (arg=="--nodes") options.solver.maxNodes=std::atoll(value.c_str());
+        else if (arg=="--seconds") options.solver.maxSeconds=std::atof(value.c_str());
+        else if (arg=="--table-mb") options.solver.tableBytes=static_cast<std::size_t>(std::atoll(value.c_str()))<<20;
+        else if (arg=="--out") options.out=value;
+        else if (arg=="--checkpoint") options.checkpoint=value;
+        else if (arg=="--cache") options.cache=value;
+        else if (arg=="--format" && (value=="csv" || value=="bin")) options.binary=value=="bin";
+        else return false;
+    }
+    if (options.checkpoint.empty()) options.checkpoint=options.out+".ckpt";
+    return options.to>=options.from;
+
+}
+
+}
+
+int main(int argc,char** argv){
+
+    Options options;
+    options.solver.maxNodes=1000000;
+    options.solver.maxSeconds=10.0;
+    options.solver.tableBytes=64u<<20;
+    if (!parseOptions(argc,argv,options)){
+        std::cerr << "usage: solitaire-analyze --from N --to M [--threads T] [--nodes X] [--seconds S] [--table-mb MB]\n"
+                     "                         [--out FILE] [--format csv|bin] [--checkpoint FILE] [--cache FILE]\n";
+        return 1;
+    }
+    int threads=options.threads>0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    if (threads<=0) threads=1;
+
+    // Resume from the checkpoint if there is one, dropping anything written after it. Only the same run may resume 
+    Checkpoint checkpoint;
+    const std::string format=options.binary ? "bin" : "csv";
+    std::ofstream out;
+    bool resume=std::filesystem::exists(options.checkpoint) && std::filesystem::exists(options.out);
+    if (resume && (!readCheckpoint(options.checkpoint,checkpoint) || checkpoint.from!=options.from || checkpoint.to!=options.to
+        || checkpoint.format!=format || checkpoint.nextSeed<options.from)){
+        std::cerr << "solitaire-analyze: " << options.checkpoint << " isn't for --from " << options.from << " --to " << options.to
+                  << " --format " << format << ", rerun with the options it was made with or remove it to start over\n";
+        return 1;
+    }
+    if (resume){
+        std::filesystem::resize_file(options.out,checkpoint.outputBytes);
+        out.open(options.out,std::ios::binary | std::ios::app);
+        std::cerr << "resuming at deal " << checkpoint.nextSeed << "\n";
+    } else {
+        out.open(options.out,std::ios::binary | std::ios::trunc);
+        if (options.binary) out.write(binaryMagic,sizeof(binaryMagic));
+        else out << "seed,result,nodes,solution_length,seconds\n";
+        checkpoint.nextSeed=options.from;
+        checkpoint.from=options.from;
+        checkpoint.to=options.to;
+        checkpoint.format=format;
+    }
+    if (!out){
+        std::cerr << "solitaire-analyze: can't write " << options.out << "\n";
+        return 1;
+    }
+    if (checkpoint.nextSeed>options.to){
+        std::cerr << "nothing left to do\n";
+        return 0;
+    }
+    SolveCache cache;
+    if (!options.cache.empty() && !cache.open(options.cache)){
+        std::cerr << "solitaire-analyze: can't open cache " << options.cache << "\n";
+        return 1;
+    }
+
+    // Workers claim deals in order and hand results back, the main thread writes them out in deal order
+    const std::uint64_t firstSeed=checkpoint.nextSeed;
+    std::atomic<std::uint64_t> nextDeal{firstSeed};
+    std::mutex resultsLock;
+    std::map<std::uint64_t,AnalysisRecord> finished; // Results waiting for an earlier deal to finish 
+    std::condition_variable caughtUp; // Signalled as deals are written, for workers waiting to claim one too far ahead 
+    std::atomic<std::uint64_t> writtenTo{firstSeed}; // checkpoint.nextSeed, for the workers 
+    const std::uint64_t aheadWindow=std::max<std::uint64_t>(minAheadWindow,static_cast<std::uint64_t>(threads)*64);
+    std::atomic<long long> totalNodes{0};
+    std::atomic<long long> cacheHits{0};
+    std::vector<TimingStats> lookupTimes(threads); // One per worker, so adding a sample is never shared 
+
+    std::vector<std::thread> workers;
+    for (int t=0;t<threads;t++){
+        workers.emplace_back([&,t]{
+            Solver solver(options.solver);
+            Game game;
+            while (true){
+                std::uint64_t seed=nextDeal++;
+                if (seed>options.to || seed<firstSeed) break; // Past the end, or wrapped 
+                if (seed-writtenTo.load()>=aheadWindow){ // Let the deal holding up the writer finish first 
+                    std::unique_lock<std::mutex> guard(resultsLock);
+                    caughtUp.wait(guard,[&]{ return seed-writtenTo.load()<aheadWindow; });
+                }
+
+                AnalysisRecord record{};
+                record.seed=seed;
+                CachedSolve cached;
+                if (cache.isOpen()){
+                    auto start=std::chrono::steady_clock::now();
+                    bool hit=cache.lookup(seed,cached) && cached.answers(options.solver.maxNodes);
+                    lookupTimes[t].add(std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+                    if (hit){
+                        record.nodes=cached.nodes;
+                        record.micros=cached.micros;
+                        record.solutionLength=cached.solutionLength;
+                        record.result=static_cast<std::uint8_t>(cached.result);
+                        cacheHits++;
+                        std::lock_guard<std::mutex> guard(resultsLock);
+                        finished[seed]=record;
+                        continue;
+                    }
+                }
+
+                game.dealNewGame(seed);
+                SolveOutcome outcome=solver.solve(game);
+                record.nodes=static_cast<std::uint64_t>(outcome.stats.nodes);
+                record.micros=static_cast<std::uint32_t>(outcome.stats.seconds*1e6);
+                record.solutionLength=static_cast<std::uint16_t>(outcome.solution.size());
+                record.result=static_cast<std::uint8_t>(outcome.result);
+                totalNodes+=outcome.stats.nodes;
+                if (cache.isOpen()){
+                    cached.result=outcome.result;
+                    cached.nodes=record.nodes;
+                    cached.micros=record.micros;
+                    cached.solutionLength=record.solutionLength;
+                    cache.store(seed,cached);
+                }
+
+                std::lock_guard<std::mutex> guard(resultsLock);
+                finished[seed]=record;
+            }
+        });
+    }
+
+    std::uint64_t total=options.to-firstSeed+1;
+    std::uint64_t written=0;
+    long long counts[3]={0,0,0};
+    auto start=std::chrono::steady_clock::now();
+    auto lastCheckpoint=start;
+
+    while (written<total){
+        std::vector<AnalysisRecord> ready;
+        {
+            std::lock_guard<std::mutex> guard(resultsLock);
+            while (!finished.empty() && finished.begin()->first==checkpoint.nextSeed+ready.size()){
+                ready.push_back(finished.begin()->second);
+                finished.erase(finished.begin());
+            }
+        }
+        for (const AnalysisRecord& record : ready){
+            writeRecord(out,record,options.binary);
+            counts[record.result]++;
+        }
+        checkpoint.nextSeed+=ready.size();
+        written+=ready.size();
+        if (!ready.empty()){
+            {
+                std::lock_guard<std::mutex> guard(resultsLock); // So a worker can't check and then miss the wake up 
+                writtenTo.store(checkpoint.nextSeed);
+            }
+            caughtUp.notify_all();
+        }
+
+        auto now=std::chrono::steady_clock::now();
+        if (written==total || now-lastCheckpoint>=std::chrono::seconds(5)){
+            out.flush();
+            checkpoint.outputBytes=static_cast<std::uint64_t>(out.tellp());
+            writeCheckpoint(options.checkpoint,checkpoint);
+            lastCheckpoint=now;
+
+            double seconds=std::chrono::duration<double>(now-start).count();
+            std::fprintf(stderr,"%llu/%llu deals, %.1f deals/sec, %.2f M nodes/sec, solved %lld unsolvable %lld out-of-budget %lld\n",
+                static_cast<unsigned long long>(written),static_cast<unsigned long long>(total),written/seconds,
+                totalNodes.load()/seconds/1e6,counts[0],counts[1],counts[2]);
+            if (cache.isOpen()) std::fprintf(stderr,"  cache hits %lld ( %.1f%% )\n",cacheHits.load(),written ? 100.0*cacheHits.load()/written : 0.0);
+        }
+        if (ready.empty()) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    for (std::thread& worker : workers) worker.join();
+    if (cache.isOpen()){
+        TimingStats lookups;
+        for (const TimingStats& times : lookupTimes) lookups.merge(times);
+        std::fprintf(stderr,"cache lookups %zu, %.1f%% hits, latency us p50 %.2f p99 %.2f max %.2f\n",lookups.count(),
+            lookups.count() ? 100.0*cacheHits.load()/lookups.count() : 0.0,lookups.percentile(0.5)*1e6,lookups.percentile(0.99)*1e6,
+            lookups.max()*1e6);
+    }
+    return 0;
+
+}
@@ -0,0 +1,119 @@
+// atlas.cpp
+// solitaire-atlas, the asset build step behind make atlas. Packs every card frame of Spritesheet.png, the Undo and
+// NewDeal buttons and a white pixel for plain colour quads into one image, and writes where each landed as the table
+// Spritesheet::loadAtlas reads ( see Atlas.h ). Only the sheet's frames are packed, its unused cells are left out.
+// Needs SFML for its image loading
+//
+// Usage: solitaire-atlas [--assets dir] [--out prefix]
+//   --assets dir       Where Spritesheet.png, Undo.png and NewDeal.png are, default assets
+//   --out prefix       Writes prefix.png and prefix.bin, default assets/atlas
+//
+// Exits 0 once both files are written, 1 if an asset can't be read or the atlas can't be written.
+
+#include "Atlas.h"
+#include "Spritesheet.h"
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr unsigned padding=1; // Transparent pixels between pictures
+constexpr unsigned maxSize=8192;
+constexpr unsigned solidSize=3; // The white block, its middle pixel is what plain colour quads sample
+
+// A picture to place: where it comes from and the table entry it becomes
+struct Piece{
+    const sf::Image* source=nullptr; // nullptr for the white block
+    sf::IntRect from;
+    AtlasEntry entry{};
+};
+
+Piece piece(std::uint32_t key,const sf::Image* source,sf::IntRect from){
+    Piece p;
+    p.source=source;
+    p.from=from;
+    p.entry.key=key;
+    p.entry.width=static_cast<std::uint16_t>(from.size.x);
+    p.entry.height=static_cast<std::uint16_t>(from.size.y);
+    return p;
+}
+
+}
+
+int main(int argc,char** argv){
+
+    std::string assets="assets";
+    std::string out="assets/atlas";
+    for (int i=1;i<argc;i++){
+        std::string arg=argv[i];
+        if (arg=="--assets" && i+1<argc) assets=argv[++i];
+        else if (arg=="--out" && i+1<argc) out=argv[++i];
+        else {
+            std::cerr << "usage: solitaire-atlas [--assets dir] [--out prefix]\n";
+            return 1;
+        }
+    }
+
+    sf::Image sheet, undo, newDeal;
+    if (!sheet.loadFromFile(assets+"/Spritesheet.png") || !undo.loadFromFile(assets+"/Undo.png")
+        || !newDeal.loadFromFile(assets+"/NewDeal.png")){
+        std::cerr << "solitaire-atlas: can't read the assets in " << assets << "\n";
+        return 1;
+    }
+
+    std::vector<Piece> pieces;
+    std::array<sf::IntRect,Spritesheet::frameCount> frames=Spritesheet::sheetLayout(sheet.getSize());
+    for (int frame=0;frame<Spritesheet::frameCount;frame++) pieces.push_back(piece(AtlasKey::frame(frame),&sheet,frames[frame]));
+    pieces.push_back(piece(AtlasKey::undo,&undo,sf::IntRect({0,0},sf::Vector2i(undo.getSize()))));
+    pieces.push_back(piece(AtlasKey::newDeal,&newDeal,sf::IntRect({0,0},sf::Vector2i(newDeal.getSize()))));
+    pieces.push_back(piece(AtlasKey::solid,nullptr,sf::IntRect({0,0},{static_cast<int>(solidSize),static_cast<int>(solidSize)})));
+
+    // Narrowest square-ish atlas everything fits in
+    std::vector<AtlasRect> rects(pieces.size());
+    for (std::size_t i=0;i<pieces.size();i++){
+        rects[i].width=static_cast<unsigned>(pieces[i].from.size.x);
+        rects[i].height=static_cast<unsigned>(pieces[i].from.size.y);
+    }
+    unsigned width=256, height=0;
+    for (;width<=maxSize;width*=2){
+        height=packShelves(rects,width,padding);
+        if (height>0 && height<=width) break;
+    }
+    if (width>maxSize){
+        std::cerr << "solitaire-atlas: the assets don't fit in " << maxSize << "x" << maxSize << "\n";
+        return 1;
+    }
+
+    sf::Image atlas({width,height},sf::Color::Transparent);
+    AtlasTable table;
+    table.setSize(static_cast<std::uint16_t>(width),static_cast<std::uint16_t>(height));
+    for (std::size_t i=0;i<pieces.size();i++){
+        Piece& p=pieces[i];
+        p.entry.x=static_cast<std::uint16_t>(rects[i].x);
+        p.entry.y=static_cast<std::uint16_t>(rects[i].y);
+        if (p.source){
+            if (!atlas.copy(*p.source,{rects[i].x,rects[i].y},p.from)){
+                std::cerr << "solitaire-atlas: can't copy entry " << p.entry.key << "\n";
+                return 1;
+            }
+        } else {
+            for (unsigned y=0;y<rects[i].height;y++){
+                for (unsigned x=0;x<rects[i].width;x++) atlas.setPixel({rects[i].x+x,rects[i].y+y},sf::Color::White);
+            }
+        }
+        table.add(p.entry);
+    }
+
+    if (!atlas.saveToFile(out+".png") || !table.save(out+".bin")){
+        std::cerr << "solitaire-atlas: can't write " << out << ".png and " << out << ".bin\n";
+        return 1;
+    }
+    std::printf("%s.png %ux%u, %zu entries, %.1f KiB GPU\n",out.c_str(),width,height,table.getEntries().size(),
+        width*height*4/1024.0);
+    return 0;
+
+}
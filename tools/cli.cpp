@@ -0,0 +1,226 @@
+// cli.cpp
+// solitaire-cli, runs deals and move scripts against the rules engine without opening a window
+//
+// Usage: solitaire-cli [-q] [-r recording] [script ...]
+// -r records the session for solitaire-replay, see Recording.h
+// Reads each script ( or stdin if none are given, or for "-" ) one command per line:
+//   new [seed]         -- Deal a new game, optionally deal number seed
+//   undo               -- Undo the latest move
+//   redo               -- Make the latest undone move again
+//   auto               -- Move every card that is safe to go up to the foundations, undone as one with the move before
+//   print              -- Print the current position
+//   save <file>        -- Save the game, history included, to a snapshot file ( see Snapshot.h )
+//   load <file>        -- Load a game saved with save
+//   moves              -- Print every legal move
+//   solve [nodes]      -- Search for a win from the current position, optionally with a node budget
+//   solve-shortest [nodes] -- As solve, but keeps searching for shorter solutions until the budget runs out
+//   solve-parallel [nodes] -- As solve, spread over every core 
+//   hint [samples]     -- Rank the legal moves by estimated chance of winning, without looking at hidden cards
+//   <move>             -- A move in the notation of Notation.h, i.e. draw or t2:4>t5
+// Anything after a '#' is a comment.
+
+#include "Game.h"
+#include "HintEngine.h"
+#include "Notation.h"
+#include "ParallelSolver.h"
+#include "Recording.h"
+#include "Snapshot.h"
+#include "Solver.h"
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+// -- Runs the solver on the current position and prints its verdict, statistics and solution
+void runSolver(const Game& game, long long nodes, const std::string& mode, bool quiet){
+
+    SolverConfig config;
+    if (nodes>0) config.maxNodes=nodes;
+    config.findShortest=mode=="solve-shortest";
+    SolveOutcome outcome;
+    if (mode=="solve-parallel"){
+        ParallelSolver solver(config);
+        outcome=solver.solve(game);
+    } else {
+        Solver solver(config);
+        outcome=solver.solve(game);
+    }
+
+    std::cout << solveResultName(outcome.result);
+    if (outcome.result==SolveResult::Solved){
+        std::cout << " in " << outcome.solution.size() << " moves" << (outcome.shortestProven ? " (shortest)" : "");
+    }
+    std::cout << ", " << outcome.stats.nodes << " nodes, " << outcome.stats.nodesPerSecond()/1e6 << " M nodes/sec, "
+              << outcome.stats.tableBytes/1024 << " KB table (" << outcome.stats.tableEntries << " entries)\n";
+    if (!quiet && !outcome.solution.empty()){
+        for (size_t i=0;i<outcome.solution.size();i++) std::cout << (i ? " " : "") << formatMove(outcome.solution[i]);
+        std::cout << "\n";
+    }
+}
+
+struct Stats {
+    long commands=0;
+    long moves=0;
+    long errors=0;
+    long illegal=0;
+};
+
+// -- Prints the best few moves from the HintEngine and how fast it sampled
+void runHint(const Game& game, int samples, bool quiet){
+
+    HintConfig config;
+    if (samples>0) config.samples=samples;
+    HintEngine engine(config);
+    HintReport report=engine.hint(game);
+    if (quiet) return;
+
+    std::cout << "hint: " << report.samples << " samples in " << report.seconds*1000.0 << " ms, "
+              << report.samplesPerSecond() << " samples/sec on " << engine.threads() << " threads"
+              << (report.deadlineHit ? ", deadline hit" : "") << "\n";
+    for (std::size_t i=0;i<report.moves.size() && i<5;i++){
+        const MoveHint& move=report.moves[i];
+        std::cout << "  " << formatMove(move.move) << "  " << static_cast<int>(move.winRate()*100.0+0.5) << "% won, "
+                  << move.losses << "/" << move.samples << " proven lost\n";
+    }
+}
+
+// -- Runs every command in a script, returns false if the script couldn't be read
+bool runScript(std::istream& in, const std::string& name, Game& game, Stats& stats, bool quiet, SessionRecorder& recorder){
+
+    // in -- The script stream
+    // name -- Script name, used for error messages
+    // game -- The game the commands are applied to
+    // stats -- Counters updated per command
+    // quiet -- Whether to suppress 'print' output
+    // recorder -- Records each action that changed the game, if open
+
+    std::string line;
+    int lineNumber=0;
+    while (std::getline(in,line)){
+        lineNumber++;
+        size_t comment=line.find('#');
+        if (comment!=std::string::npos) line.erase(comment);
+
+        std::istringstream words(line);
+        std::string command;
+        while (words >> command){
+            stats.commands++;
+            if (command=="new"){
+                std::uint64_t seed;
+                words >> std::ws;
+                if (std::isdigit(words.peek()) && words >> seed) game.dealNewGame(seed);
+                else game.dealNewGame();
+                recorder.deal(game.getDealSeed());
+            } else if (command=="undo"){
+                game.undo();
+                recorder.undo();
+            } else if (command=="redo"){
+                game.redo();
+                recorder.redo();
+            } else if (command=="auto"){
+                int moved=game.autoComplete();
+                if (moved>0) recorder.autoComplete();
+                if (!quiet) std::cout << moved << " to the foundations\n";
+            } else if (command=="save" || command=="load"){
+                std::string path;
+                if (!(words >> path)){
+                    std::cerr << name << ":" << lineNumber << ": " << command << " needs a file\n";
+                    stats.errors++;
+                } else if (command=="load" && recorder.isOpen()){
+                    std::cerr << name << ":" << lineNumber << ": can't load while recording, replays start from a deal\n";
+                    stats.errors++;
+                } else if (!(command=="save" ? saveSnapshot(game,path) : loadSnapshot(game,path))){
+                    std::cerr << name << ":" << lineNumber << ": could not " << command << " '" << path << "'\n";
+                    stats.errors++;
+                }
+            } else if (command=="print"){
+                if (!quiet) printGame(std::cout,game);
+            } else if (command=="solve" || command=="solve-shortest" || command=="solve-parallel"){
+                long long nodes=0;
+                words >> std::ws;
+                if (std::isdigit(words.peek())) words >> nodes;
+                runSolver(game,nodes,command,quiet);
+            } else if (command=="hint"){
+                int samples=0;
+                words >> std::ws;
+                if (std::isdigit(words.peek())) words >> samples;
+                runHint(game,samples,quiet);
+            } else if (command=="moves"){
+                Game::MoveBuffer moves;
+                int count=game.generateMoves(moves);
+                if (quiet) continue;
+                for (int i=0;i<count;i++) std::cout << (i ? " " : "") << formatMove(moves[i]);
+                std::cout << "\n";
+            } else {
+                Move move;
+                if (!parseMove(game,command,move)){
+                    std::cerr << name << ":" << lineNumber << ": bad command '" << command << "'\n";
+                    stats.errors++;
+                    continue;
+                }
+                if (!game.applyMove(move)){
+                    if (!quiet) std::cerr << name << ":" << lineNumber << ": illegal move '" << command << "'\n";
+                    stats.illegal++;
+                    continue;
+                }
+                recorder.move(move);
+                stats.moves++;
+            }
+        }
+    }
+    return !in.bad();
+}
+
+}
+
+int main(int argc, char** argv){
+
+    bool quiet=false;
+    Game game;
+    game.dealNewGame();
+    Stats stats;
+    SessionRecorder recorder;
+
+    auto start=std::chrono::steady_clock::now();
+    bool readStdin=true;
+    for (int i=1;i<argc;i++){
+        if (std::strcmp(argv[i],"-q")==0){
+            quiet=true;
+            continue;
+        }
+        if (std::strcmp(argv[i],"-r")==0 && i+1<argc){
+            if (!recorder.open(argv[++i])){
+                std::cerr << "solitaire-cli: can't create " << argv[i] << "\n";
+                return 1;
+            }
+            recorder.deal(game.getDealSeed());
+            continue;
+        }
+        readStdin=false;
+        if (std::strcmp(argv[i],"-")==0){
+            runScript(std::cin,"<stdin>",game,stats,quiet,recorder);
+            continue;
+        }
+        std::ifstream file(argv[i]);
+        if (!file || !runScript(file,argv[i],game,stats,quiet,recorder)){
+            std::cerr << "solitaire-cli: can't read " << argv[i] << "\n";
+            return 1;
+        }
+    }
+    if (readStdin) runScript(std::cin,"<stdin>",game,stats,quiet,recorder);
+    if (recorder.isOpen() && !recorder.finish(game)){
+        std::cerr << "solitaire-cli: recording not fully written\n";
+        stats.errors++;
+    }
+    double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    std::cout << stats.commands << " commands, " << stats.moves << " moves, " << stats.illegal << " illegal, "
+              << stats.errors << " errors in "
+              << seconds*1000.0 << " ms" << (game.getWon() ? ", won" : "") << "\n";
+    return stats.errors==0 ? 0 : 2;
+}
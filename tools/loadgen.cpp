@@ -0,0 +1,238 @@
+// loadgen.cpp
+// solitaire-loadgen, drives a solitaire-server with many sessions at once and reports how many games one server holds,
+// moves per second and request latency. Each connection plays its own share of the sessions with random legal moves,
+// undos, redeals and now and then a close and reopen, mirroring every game locally to check each reply's hash
+//
+// Usage: solitaire-loadgen [--connect address] [--sessions N] [--connections C] [--pipeline K] [--seconds S]
+//   --connect address  Server to drive, see GameServer.h. Without it a server is started in this process
+//   --sessions N       Sessions kept open, default 10000
+//   --connections C    Connections, each on its own thread, default 4
+//   --pipeline K       Requests each connection sends before reading the replies, default 16
+//   --seconds S        How long to play, default 5
+//
+// Exits 0 if every reply was what the local mirror expected.
+
+#include "Game.h"
+#include "GameServer.h"
+#include "Notation.h"
+#include "TimingStats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock=std::chrono::steady_clock;
+
+struct Options{
+    std::string address;
+    int sessions=10000;
+    int connections=4;
+    int pipeline=16;
+    double seconds=5.0;
+};
+
+struct Totals{
+    std::uint64_t requests=0;
+    std::uint64_t moves=0;
+    std::uint64_t errors=0;
+    double openSeconds=0; // Opening this connection's sessions
+    double playSeconds=0;
+    std::vector<double> latencies;
+};
+
+// One session as this client expects it to be
+struct Mirror{
+    std::uint32_t id=0;
+    Game game;
+    int moves=0; // Since it was last dealt
+};
+
+// -- Sends what's pending and checks each reply against the hash its mirror expects
+bool exchange(GameClient& client,const std::vector<Request>& requests,std::vector<Mirror*>& owners,std::vector<std::uint64_t>& expected,Totals& totals){
+
+    auto sent=Clock::now();
+    if (!client.send(requests.data(),requests.size())) return false;
+    for (std::size_t i=0;i<requests.size();i++){
+        Response response;
+        if (!client.receive(response)) return false;
+        totals.latencies.push_back(std::chrono::duration<double>(Clock::now()-sent).count());
+        totals.requests++;
+        if (requests[i].op==Op::Open) owners[i]->id=response.session;
+        if (response.status!=Status::Ok || (requests[i].op!=Op::Close && response.hash!=expected[i])) totals.errors++;
+    }
+    return true;
+
+}
+
+void play(const Options& options,int sessions,std::uint64_t seed,Totals& totals){
+
+    GameClient client;
+    if (!client.connect(options.address)){
+        totals.errors++;
+        return;
+    }
+
+    std::mt19937_64 rng(seed);
+    std::vector<Mirror> mirrors(sessions);
+    std::vector<Request> requests;
+    std::vector<Mirror*> owners;
+    std::vector<std::uint64_t> expected;
+    auto queue=[&](Mirror& mirror,Request request){
+        requests.push_back(request);
+        owners.push_back(&mirror);
+        expected.push_back(mirror.game.getHash());
+    };
+    auto flush=[&](){
+        bool ok=exchange(client,requests,owners,expected,totals);
+        requests.clear();
+        owners.clear();
+        expected.clear();
+        if (!ok) totals.errors++;
+        return ok;
+    };
+
+    auto start=Clock::now();
+    for (Mirror& mirror : mirrors){
+        Request open{Op::Open};
+        open.seed=rng();
+        mirror.game.dealNewGame(open.seed);
+        queue(mirror,open);
+        if (requests.size()>=256 && !flush()) return;
+    }
+    if (!requests.empty() && !flush()) return;
+    totals.latencies.clear(); // Only play is measured
+    totals.requests=0;
+    totals.openSeconds=std::chrono::duration<double>(Clock::now()-start).count();
+    start=Clock::now();
+    auto deadline=start+std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+
+    // A session at most once per batch, its request is built from the mirror before the batch's replies come back 
+    int batch=std::min(options.pipeline,sessions);
+    Game::MoveBuffer moves;
+    std::size_t next=0;
+    while (Clock::now()<deadline){
+        for (int k=0;k<batch;k++){
+            Mirror& mirror=mirrors[next++%mirrors.size()];
+            Request request{Op::Move};
+            request.session=mirror.id;
+            int count=mirror.game.generateMoves(moves);
+            unsigned roll=static_cast<unsigned>(rng()%100);
+
+            if (mirror.game.getWon() || count==0 || mirror.moves>=300 || roll==0){
+                if (roll==0){ // Hand the game back and take a fresh one, the pool's churn path
+                    request.op=Op::Close;
+                    queue(mirror,request);
+                    request.op=Op::Open;
+                } else {
+                    request.op=Op::Deal;
+                }
+                request.seed=rng();
+                mirror.game.dealNewGame(request.seed);
+                mirror.moves=0;
+            } else if (roll<8 && mirror.game.canUndo()){
+                request.op=Op::Undo;
+                mirror.game.undo();
+            } else {
+                const Move& move=moves[rng()%count];
+                int from,to,index;
+                movePiles(move,from,to,index);
+                request.from=static_cast<std::uint8_t>(from);
+                request.to=static_cast<std::uint8_t>(to);
+                request.index=static_cast<std::uint8_t>(index);
+                mirror.game.applyMove(move);
+                mirror.moves++;
+                totals.moves++;
+            }
+            queue(mirror,request);
+        }
+        if (!flush()) return;
+    }
+    totals.playSeconds=std::chrono::duration<double>(Clock::now()-start).count();
+
+}
+
+}
+
+int main(int argc,char** argv){
+
+    Options options;
+    for (int i=1;i<argc;i++){
+        std::string arg=argv[i];
+        if (i+1>=argc){
+            std::cerr << "usage: solitaire-loadgen [--connect address] [--sessions N] [--connections C] [--pipeline K] [--seconds S]\n";
+            return 1;
+        }
+        if (arg=="--connect") options.address=argv[++i];
+        else if (arg=="--sessions") options.sessions=std::atoi(argv[++i]);
+        else if (arg=="--connections") options.connections=std::atoi(argv[++i]);
+        else if (arg=="--pipeline") options.pipeline=std::atoi(argv[++i]);
+        else if (arg=="--seconds") options.seconds=std::atof(argv[++i]);
+        else i++;
+    }
+    if (options.connections<1) options.connections=1;
+    if (options.pipeline<1) options.pipeline=1;
+    if (options.sessions<options.connections) options.sessions=options.connections;
+
+    // Without a server to drive, run one here on a Unix socket of our own
+    std::unique_ptr<GameServer> local;
+    std::thread serving;
+    if (options.address.empty()){
+        options.address="/tmp/solitaire-loadgen-"+std::to_string(std::random_device{}())+".sock";
+        local=std::make_unique<GameServer>();
+        if (!local->listen(options.address)){
+            std::cerr << "solitaire-loadgen: can't start a server: " << local->error() << "\n";
+            return 1;
+        }
+        serving=std::thread([&]{ local->run(); });
+    }
+
+    std::vector<Totals> totals(options.connections);
+    std::vector<std::thread> threads;
+    for (int c=0;c<options.connections;c++){
+        int share=options.sessions/options.connections+(c<options.sessions%options.connections ? 1 : 0);
+        threads.emplace_back(play,std::cref(options),share,0x10AD0000u+c,std::ref(totals[c]));
+    }
+    for (std::thread& t : threads) t.join();
+
+    Totals all;
+    TimingStats latency;
+    for (const Totals& t : totals){
+        all.requests+=t.requests;
+        all.moves+=t.moves;
+        all.errors+=t.errors;
+        all.openSeconds=std::max(all.openSeconds,t.openSeconds);
+        all.playSeconds=std::max(all.playSeconds,t.playSeconds);
+        for (double l : t.latencies) latency.add(l);
+    }
+
+    GameClient client;
+    Response response;
+    ServerStats stats{};
+    if (!client.connect(options.address) || !client.call(Request{Op::Stats},response,&stats,sizeof(stats))) all.errors++;
+
+    if (local){
+        local->stop();
+        serving.join();
+    }
+
+    double seconds=all.playSeconds>0 ? all.playSeconds : 1.0;
+    std::cout << stats.sessions << " sessions open, " << stats.poolBytes/1024 << " KiB pooled, "
+              << (stats.sessions ? stats.poolBytes/stats.sessions : 0) << " bytes/session, opened in "
+              << all.openSeconds << " s\n"
+              << all.requests << " requests ( " << all.moves << " moves ) in " << seconds << " s over "
+              << options.connections << " connections, " << all.moves/seconds << " moves/sec, "
+              << all.requests/seconds << " requests/sec\n"
+              << "latency ms p50 " << latency.percentile(0.5)*1e3 << " p90 " << latency.percentile(0.9)*1e3
+              << " p99 " << latency.percentile(0.99)*1e3 << " max " << latency.max()*1e3
+              << " ( pipeline " << options.pipeline << " )\n"
+              << all.errors << " errors\n";
+    return all.errors==0 ? 0 : 2;
+}
@@ -0,0 +1,130 @@
+// replay.cpp
+// solitaire-replay, plays session recordings back through the rules engine as fast as it goes and checks each one
+// ends on the position it was recorded with. Run over a folder of real sessions it is the load test before an upgrade,
+// and a single failing recording reproduces its bug exactly
+//
+// Usage: solitaire-replay [--threads T] [--repeat N] path ...
+//   path               A recording ( see Recording.h ), or a folder searched for them 
+//   --threads T        Worker threads, default one per core
+//   --repeat N         Replay everything N times, for steadier throughput numbers, default 1
+//
+// Exits 0 if every recording replayed to its recorded final position.
+
+#include "Game.h"
+#include "MappedFile.h"
+#include "Recording.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options{
+    int threads=0;
+    int repeat=1;
+    std::vector<std::string> paths;
+};
+
+bool parseOptions(int argc,char** argv,Options& options){
+
+    for (int i=1;i<argc;i++){
+        std::string arg=argv[i];
+        if (arg=="--threads" || arg=="--repeat"){
+            if (i+1>=argc) return false;
+            int value=std::atoi(argv[++i]);
+            (arg=="--threads" ? options.threads : options.repeat)=value;
+        } else {
+            options.paths.push_back(arg);
+        }
+    }
+    return !options.paths.empty() && options.repeat>0;
+
+}
+
+// -- Adds path, or every regular file under it if it is a folder, to files
+void collect(const std::string& path,std::vector<std::string>& files){
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(path,error)){
+        files.push_back(path);
+        return;
+    }
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(path,error)){
+        if (entry.is_regular_file()) files.push_back(entry.path().string());
+    }
+
+}
+
+}
+
+int main(int argc,char** argv){
+
+    Options options;
+    if (!parseOptions(argc,argv,options)){
+        std::cerr << "usage: solitaire-replay [--threads T] [--repeat N] recording-or-folder ...\n";
+        return 1;
+    }
+    int threads=options.threads>0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    if (threads<=0) threads=1;
+
+    std::vector<std::string> files;
+    for (const std::string& path : options.paths) collect(path,files);
+
+    // Map everything up front so the timed part is only the engine 
+    std::vector<MappedFile> recordings(files.size());
+    int unreadable=0;
+    for (std::size_t i=0;i<files.size();i++){
+        if (!recordings[i].open(files[i])){
+            std::cerr << files[i] << ": can't open\n";
+            unreadable++;
+        }
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<long long> events{0}, moves{0}, recordedMillis{0};
+    std::atomic<int> failed{0}, incomplete{0};
+    std::mutex reportLock;
+    const std::size_t jobs=files.size()*static_cast<std::size_t>(options.repeat);
+
+    auto start=std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t=0;t<threads;t++){
+        workers.emplace_back([&]{
+            Game game;
+            long long localEvents=0, localMoves=0;
+            for (std::size_t job=next++;job<jobs;job=next++){
+                std::size_t i=job%files.size();
+                if (!recordings[i].isOpen()) continue;
+                ReplayResult result=replayRecording(recordings[i].data(),recordings[i].size(),game);
+                localEvents+=static_cast<long long>(result.events);
+                localMoves+=static_cast<long long>(result.moves);
+                if (job>=files.size()) continue; // Repeats only add load, report each recording once 
+                recordedMillis+=result.millis;
+                if (result.ok) continue;
+                (result.complete ? failed : incomplete)++;
+                std::lock_guard<std::mutex> lock(reportLock);
+                std::cerr << files[i] << ": " << result.error << "\n";
+            }
+            events+=localEvents;
+            moves+=localMoves;
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    std::size_t replayed=files.size()-unreadable;
+    std::cout << replayed << " recordings ( " << recordedMillis/1000.0 << " s of play ), "
+              << replayed-failed-incomplete << " ok, " << failed << " failed, " << incomplete << " incomplete\n";
+    std::cout << jobs-unreadable*static_cast<std::size_t>(options.repeat) << " replays of " << events << " events ( "
+              << moves << " moves ) in " << seconds*1000.0 << " ms on " << threads << " threads, "
+              << events/seconds/1e6 << " M events/sec, " << (jobs-unreadable*static_cast<std::size_t>(options.repeat))/seconds
+              << " recordings/sec\n";
+    return failed==0 && incomplete==0 && unreadable==0 ? 0 : 2;
+
+}
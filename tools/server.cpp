@@ -0,0 +1,56 @@
+// server.cpp
+// solitaire-server, hosts games for clients on a local socket, see GameServer.h and Protocol.h
+//
+// Usage: solitaire-server [--sessions N] address
+//   address            "host:port" or ":port" for TCP, otherwise a Unix socket path
+//   --sessions N       Most sessions open at once, default and at most 1048576
+//
+// Runs until interrupted, then prints what it served.
+
+#include "GameServer.h"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+GameServer* running=nullptr;
+
+void interrupted(int){
+    if (running) running->stop();
+}
+
+}
+
+int main(int argc,char** argv){
+
+    std::string address;
+    std::uint32_t sessions=SessionPool::maxSlots;
+    for (int i=1;i<argc;i++){
+        std::string arg=argv[i];
+        if (arg=="--sessions" && i+1<argc) sessions=static_cast<std::uint32_t>(std::strtoul(argv[++i],nullptr,10));
+        else address=arg;
+    }
+    if (address.empty() || sessions==0){
+        std::cerr << "usage: solitaire-server [--sessions N] address\n";
+        return 1;
+    }
+
+    GameServer server(sessions);
+    if (!server.listen(address)){
+        std::cerr << "solitaire-server: can't listen on " << address << ": " << server.error() << "\n";
+        return 1;
+    }
+    running=&server;
+    std::signal(SIGINT,interrupted);
+    std::signal(SIGTERM,interrupted);
+    std::cout << "solitaire-server: listening on " << address << std::endl;
+    server.run();
+    running=nullptr;
+
+    const SessionPool& pool=server.getPool();
+    std::cout << "solitaire-server: " << pool.live() << " sessions open of " << pool.slots() << " pooled, "
+              << pool.bytes()/1024 << " KiB\n";
+    return 0;
+}
@@ -0,0 +1,387 @@
+// stress.cpp
+// solitaire-stress, plays random legal moves, undos and redos on every core and checks the engine's invariants after
+// every step, so bookkeeping that only goes wrong deep into a game is caught. Doubles as a throughput benchmark.
+//
+// Usage: solitaire-stress [options]
+//   --threads T        Worker threads, default one per core
+//   --seconds S        How long to run, default 10
+//   --seed N           Seed for the whole run, default 1. Game g of a run always plays the same way
+//   --rules NAME       klondike ( default ), draw-three, vegas or relaxed, see Rules.h
+//   --game G           Only play game G of the run, to reproduce a failure
+//   --solver N         Instead, checks the Solver's shortest solutions on N endgames, see below
+//
+// After every step:
+//   * every card is in exactly one pile, 52 different cards
+//   * each card's Location, tableau pile and index and foundation pile say where it really is
+//   * reserve cards are face down, stockpile and foundation cards face up, each tableau pile's face up cards are one
+//     run down in alternating colours with the top card face up, each foundation one suit from the Ace up
+//   * the incremental hash matches one computed from scratch
+// After every move, undo must give back exactly the position before it ( and its hash, score and recycles ) and redo
+// the position after it. Now and then a game is undone to its deal and redone to where it was. Each deal is auto
+// completed and every undo followed by an autoComplete, which must leave the undone moves there to redo.
+//
+// With --solver, each endgame is a deal played to a few moves short of a win along a solution. A findShortest search
+// there must prove the same length as an exhaustive search without the transposition table, so the table never prunes
+// a position it hasn't really searched in as few moves. Klondike rules only, the Solver's.
+//
+// Prints moves/sec every second, counting every applyMove, undo, redo and autoComplete. Exits 2 on the first failure,
+// after printing the game, its deal number, the step and what broke.
+
+#include "Game.h"
+#include "Notation.h"
+#include "Solver.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int stepsPerGame=1000; // Before moving on to a new deal, if the game hasn't ended first
+constexpr std::size_t endgameMoves=36; // How far from the win the --solver endgames start
+
+struct Options{
+    int threads=0;
+    double seconds=10.0;
+    std::uint64_t seed=1;
+    std::string rules="klondike";
+    long long game=-1;
+    int solver=0;
+};
+
+// Everything undo has to restore, beyond the cards themselves
+struct Snapshot{
+    GameState state;
+    std::uint64_t hash;
+    int score;
+    int recycles;
+    std::size_t cursor;
+    bool operator==(const Snapshot& other) const{
+        return state==other.state && hash==other.hash && score==other.score && recycles==other.recycles && cursor==other.cursor;
+    }
+    bool operator!=(const Snapshot& other) const { return !(*this==other); }
+};
+
+template<class G>
+Snapshot snapshot(const G& game){
+    return Snapshot{game.getState(),game.getHash(),game.getScore(),game.getRecycles(),game.getHistoryCursor()};
+}
+
+bool isRed(const Card& c){
+    return c.getSuit()==Suit::Hearts || c.getSuit()==Suit::Diamonds;
+}
+
+// -- Checks every invariant in the file comment except undo's, returns what broke or nullptr
+template<class G>
+const char* checkInvariants(const G& game){
+
+    std::uint64_t seen=0;
+    int cards=0;
+
+    // Cards shared by every pile kind
+    auto visit=[&](const Card& c,Location location)->const char*{
+        std::uint64_t bit=std::uint64_t{1}<<(static_cast<int>(c.getValue()) | static_cast<int>(c.getSuit())<<4);
+        if (seen & bit) return "a card is in two places";
+        seen|=bit;
+        cards++;
+        if (c.getLocation()!=location) return "a card's Location isn't the pile it's in";
+        if (location!=Location::Tableau && (c.getTableauPile()!=-1 || c.getTableauIndex()!=-1)) return "a card outside the Tableau has a tableau index";
+        if (location!=Location::Foundation && c.getFoundationPile()!=-1) return "a card outside the foundations has a foundation pile";
+        return nullptr;
+    };
+
+    for (const Card& c : game.getReserve()){
+        if (const char* error=visit(c,Location::Reserve)) return error;
+        if (c.getFaceUp()) return "a reserve card is face up";
+    }
+    for (const Card& c : game.getStockpile()){
+        if (const char* error=visit(c,Location::Stockpile)) return error;
+        if (!c.getFaceUp()) return "a stockpile card is face down";
+    }
+    for (int t=0;t<7;t++){
+        const std::vector<Card>& pile=game.getTableau(t);
+        for (std::size_t i=0;i<pile.size();i++){
+            const Card& c=pile[i];
+            if (const char* error=visit(c,Location::Tableau)) return error;
+            if (c.getTableauPile()!=t || c.getTableauIndex()!=static_cast<int>(i)) return "a tableau card's pile or index is wrong";
+            if (i==0) continue;
+            const Card& below=pile[i-1];
+            if (below.getFaceUp() && !c.getFaceUp()) return "a face down tableau card is on a face up one";
+            if (below.getFaceUp() && (isRed(below)==isRed(c) || static_cast<int>(below.getValue())!=static_cast<int>(c.getValue())+1)){
+                return "a tableau run isn't descending in alternating colours";
+            }
+        }
+        if (!pile.empty() && !pile.back().getFaceUp()) return "a tableau pile's top card is face down";
+    }
+    for (int f=0;f<4;f++){
+        const std::vector<Card>& pile=game.getFoundation(f);
+        for (std::size_t i=0;i<pile.size();i++){
+            const Card& c=pile[i];
+            if (const char* error=visit(c,Location::Foundation)) return error;
+            if (c.getFoundationPile()!=f) return "a foundation card's pile is wrong";
+            if (!c.getFaceUp()) return "a foundation card is face down";
+            if (static_cast<int>(c.getValue())!=static_cast<int>(i) || c.getSuit()!=pile[0].getSuit()) return "a foundation isn't one suit from the Ace up";
+        }
+    }
+
+    if (cards!=52) return "cards are missing";
+    if (game.getHash()!=game.computeHash()) return "the incremental hash is wrong";
+    if (!game.getState().valid()) return "the packed state isn't valid";
+    return nullptr;
+
+}
+
+struct Shared{
+    const Options* options;
+    std::atomic<long long> nextGame{0};
+    std::atomic<long long> moves{0};
+    std::atomic<long long> games{0};
+    std::atomic<bool> stop{false};
+    std::mutex reportLock;
+    bool failed=false;
+};
+
+// -- Plays game number index of the run, returns false after reporting a failure
+template<class G>
+bool playGame(G& game,long long index,Shared& shared,long long& moves){
+
+    std::mt19937_64 rng(shared.options->seed*0x9E3779B97F4A7C15ull+static_cast<std::uint64_t>(index));
+    std::uint64_t deal=rng();
+    game.dealNewGame(deal);
+    const int dealtScore=game.getScore();
+    typename G::MoveBuffer buffer;
+    int step=0;
+    std::string action="deal";
+
+    auto fail=[&](const char* what){
+        std::lock_guard<std::mutex> guard(shared.reportLock);
+        if (!shared.failed){
+            std::fprintf(stderr,"FAILED game %lld ( deal %llu ) step %d after %s: %s\n",index,static_cast<unsigned long long>(deal),step,
+                action.c_str(),what);
+            std::fprintf(stderr,"reproduce with --seed %llu --rules %s --game %lld\n",static_cast<unsigned long long>(shared.options->seed),
+                shared.options->rules.c_str(),index);
+        }
+        shared.failed=true;
+        shared.stop=true;
+        return false;
+    };
+
+    if (GameState::dealt(deal)!=game.getState()) return fail("the deal isn't GameState::dealt");
+    if (const char* error=checkInvariants(game)) return fail(error);
+    action="deal + auto";
+    game.autoComplete(); // As the front-end does, so undo has a deal's own cascade to go back through
+    moves++;
+    if (const char* error=checkInvariants(game)) return fail(error);
+
+    // Undo as the front-end does it. An autoComplete straight after must leave every undone move there to redo
+    auto undo=[&]{
+        game.undo();
+        moves++;
+        std::size_t redoable=game.getHistory().size()-game.getHistoryCursor();
+        game.autoComplete();
+        moves++;
+        return game.canRedo() && game.getHistory().size()-game.getHistoryCursor()==redoable;
+    };
+
+    for (;step<stepsPerGame && !game.getWon() && !shared.stop.load(std::memory_order_relaxed);step++){
+        unsigned roll=static_cast<unsigned>(rng()%100);
+
+        if (roll<12 && game.canUndo()){
+            action="undo";
+            if (!undo()) return fail("autoComplete after an undo forgot the moves to redo");
+        } else if (roll<20 && game.canRedo()){
+            action="redo";
+            game.redo();
+            moves++;
+        } else if (roll==20 && game.canUndo()){ // All the way back to the deal and forward again
+            action="undo to the deal";
+            Snapshot before=snapshot(game);
+            while (game.canUndo()){
+                if (!undo()) return fail("autoComplete after an undo forgot the moves to redo");
+            }
+            if (game.getState()!=GameState::dealt(deal) || game.getScore()!=dealtScore || game.getRecycles()!=0) return fail("undoing everything didn't give back the deal");
+            if (const char* error=checkInvariants(game)) return fail(error);
+            action="redo from the deal";
+            while (game.getHistoryCursor()<before.cursor){
+                game.redo();
+                moves++;
+            }
+            if (snapshot(game)!=before) return fail("redoing everything didn't give back the position");
+        } else {
+            int count=game.generateMoves(buffer);
+            if (count==0) break;
+            const Move& move=buffer[rng()%count];
+            bool complete=roll>=90;
+            action=(move.getStartingPosition()==Location::Reserve ? std::string("draw") : formatMove(move))+(complete ? " + auto" : "");
+
+            Snapshot before=snapshot(game);
+            if (!game.applyMove(move)) return fail("a generated move was refused");
+            moves++;
+            if (complete){
+                game.autoComplete();
+                moves++;
+            }
+            if (const char* error=checkInvariants(game)) return fail(error);
+            Snapshot after=snapshot(game);
+
+            std::string name=action;
+            action=name+", undone";
+            if (!undo()) return fail("autoComplete after an undo forgot the moves to redo");
+            if (snapshot(game)!=before) return fail("undo didn't give back the position before the move");
+            if (const char* error=checkInvariants(game)) return fail(error);
+            action=name+", redone";
+            game.redo();
+            moves++;
+            if (snapshot(game)!=after) return fail("redo didn't give back the position after the move");
+        }
+        if (const char* error=checkInvariants(game)) return fail(error);
+    }
+    return true;
+
+}
+
+template<class G>
+void worker(Shared& shared){
+    G game;
+    long long moves=0;
+    while (!shared.stop.load(std::memory_order_relaxed)){
+        long long index=shared.options->game>=0 ? shared.options->game : shared.nextGame++;
+        bool ok=playGame(game,index,shared,moves);
+        shared.moves+=moves;
+        moves=0;
+        shared.games++;
+        if (!ok || shared.options->game>=0) break;
+    }
+}
+
+template<class G>
+int run(const Options& options){
+
+    int threads=options.game>=0 ? 1 : options.threads>0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    if (threads<=0) threads=1;
+    Shared shared;
+    shared.options=&options;
+
+    using Clock=std::chrono::steady_clock;
+    auto start=Clock::now();
+    std::vector<std::thread> workers;
+    for (int t=0;t<threads;t++) workers.emplace_back([&]{ worker<G>(shared); });
+
+    long long lastMoves=0;
+    auto lastReport=start;
+    auto end=start+std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+    while (!shared.stop && (options.game<0 ? Clock::now()<end : shared.games.load()==0)){
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto now=Clock::now();
+        if (now-lastReport>=std::chrono::seconds(1)){
+            long long moves=shared.moves.load();
+            std::fprintf(stderr,"%lld games, %.2f M moves/sec\n",shared.games.load(),
+                (moves-lastMoves)/std::chrono::duration<double>(now-lastReport).count()/1e6);
+            lastMoves=moves;
+            lastReport=now;
+        }
+    }
+    shared.stop=true;
+    for (std::thread& t : workers) t.join();
+
+    double seconds=std::chrono::duration<double>(Clock::now()-start).count();
+    std::printf("%s: %lld games, %lld moves in %.1f s on %d threads, %.2f M moves/sec, %s\n",options.rules.c_str(),
+        shared.games.load(),shared.moves.load(),seconds,threads,shared.moves.load()/seconds/1e6,shared.failed ? "FAILED" : "no invariant broken");
+    return shared.failed ? 2 : 0;
+
+}
+
+// -- The --solver check, returns the exit code
+int checkSolver(const Options& options){
+
+    SolverConfig plain;
+    plain.maxNodes=5000000;
+    plain.maxSeconds=0.0;
+    plain.findShortest=true;
+    plain.useTable=false;
+    SolverConfig tabled=plain;
+    tabled.useTable=true;
+
+    int checked=0, skipped=0;
+    for (std::uint64_t index=0;checked<options.solver;index++){
+        std::mt19937_64 rng(options.seed*0x9E3779B97F4A7C15ull+index);
+        std::uint64_t deal=rng();
+        Game game;
+        game.dealNewGame(deal);
+        SolverConfig any;
+        any.maxNodes=2000000;
+        SolveOutcome first=Solver(any).solve(game);
+        if (first.result!=SolveResult::Solved) continue; // Only a winnable deal has an endgame to check
+
+        // Play the solution up to a few moves from its end
+        std::size_t start=first.solution.size()>endgameMoves ? first.solution.size()-endgameMoves : 0;
+        for (std::size_t i=0;i<start;i++) game.applyMove(first.solution[i]);
+
+        SolveOutcome expected=Solver(plain).solve(game);
+        if (expected.result!=SolveResult::Solved || !expected.shortestProven){ // Too wide to search without the table
+            skipped++;
+            if (skipped>options.solver*4){
+                std::fprintf(stderr,"solitaire-stress: too many endgames out of budget\n");
+                return 1;
+            }
+            continue;
+        }
+        SolveOutcome actual=Solver(tabled).solve(game);
+        if (actual.result!=SolveResult::Solved || !actual.shortestProven || actual.solution.size()!=expected.solution.size()){
+            std::fprintf(stderr,"FAILED deal %llu after %zu moves: exhaustive search wins in %zu, with the table %s in %zu%s\n",
+                static_cast<unsigned long long>(deal),start,expected.solution.size(),solveResultName(actual.result),
+                actual.solution.size(),actual.shortestProven ? " ( claimed shortest )" : "");
+            printGame(std::cerr,game);
+            return 2;
+        }
+        checked++;
+        std::printf("deal %llu: shortest %zu moves, %lld nodes exhaustive, %lld with the table\n",
+            static_cast<unsigned long long>(deal),expected.solution.size(),expected.stats.nodes,actual.stats.nodes);
+    }
+    std::printf("solver: %d endgames, shortest solutions match an exhaustive search, %d skipped as too wide\n",checked,skipped);
+    return 0;
+
+}
+
+bool parseOptions(int argc,char** argv,Options& options){
+    for (int i=1;i<argc;i++){
+        std::string arg=argv[i];
+        if (i+1>=argc) return false;
+        std::string value=argv[++i];
+        if (arg=="--threads") options.threads=std::atoi(value.c_str());
+        else if (arg=="--seconds") options.seconds=std::atof(value.c_str());
+        else if (arg=="--seed") options.seed=std::strtoull(value.c_str(),nullptr,10);
+        else if (arg=="--rules") options.rules=value;
+        else if (arg=="--game") options.game=std::atoll(value.c_str());
+        else if (arg=="--solver") options.solver=std::atoi(value.c_str());
+        else return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc,char** argv){
+
+    Options options;
+    if (!parseOptions(argc,argv,options)){
+        std::fprintf(stderr,"usage: solitaire-stress [--threads T] [--seconds S] [--seed N] [--rules klondike|draw-three|vegas|relaxed] [--game G]\n"
+            "       solitaire-stress --solver N [--seed N]\n");
+        return 1;
+    }
+    if (options.solver>0) return checkSolver(options);
+    if (options.rules=="klondike") return run<Game>(options);
+    if (options.rules=="draw-three") return run<BasicGame<DrawThreeRules>>(options);
+    if (options.rules=="vegas") return run<BasicGame<VegasRules>>(options);
+    if (options.rules=="relaxed") return run<BasicGame<RelaxedRules>>(options);
+    std::fprintf(stderr,"solitaire-stress: unknown rules %s\n",options.rules.c_str());
+    return 1;
+
+}
@@ -0,0 +1,165 @@
+// verify.cpp
+// solitaire-verify, checks claimed solutions for fixed deal competitions across every core, see Verifier.h for the
+// submission format. Prints each rejected submission with the index of its first bad move, then the throughput
+//
+// Usage: solitaire-verify [--threads T] [--all] [file ...]
+//   file               Submissions, one per line. "-", or no file at all, reads stdin as it arrives
+//   --threads T        Worker threads, default one per core
+//   --all              Print the verdict of every submission, not only the rejected ones
+//
+// Exits 0 if every submission won, 2 if any was rejected.
+
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "Verifier.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t batchLines=1<<16; // Lines verified between reports, bounds memory on endless streams
+constexpr std::size_t readBytes=8<<20;
+
+struct Totals{
+    std::uint64_t submissions=0;
+    std::uint64_t won=0;
+    std::uint64_t moves=0;
+};
+
+class Run{
+
+public:
+
+    Run(int threads,bool all) : pool(threads), all(all) {}
+
+    // -- Verifies every whole line of text, and the unterminated last one too if last. Returns the bytes used
+    std::size_t feed(std::string_view text,bool last,const std::string& name){
+
+        std::size_t used=0;
+        while (used<text.size()){
+            std::size_t end=text.find('\n',used);
+            if (end==std::string_view::npos){
+                if (!last) break;
+                end=text.size();
+            }
+            lines.push_back(text.substr(used,end-used));
+            used=end<text.size() ? end+1 : end;
+            if (lines.size()==batchLines) flush(name);
+        }
+        flush(name); // The lines point into text, so they're done before the caller reuses it
+        return used;
+
+    }
+
+    void startFile() { lineNumber=0; }
+    const Totals& getTotals() const { return totals; }
+    int threads() const { return pool.size(); }
+
+private:
+
+    void flush(const std::string& name){
+
+        verifyBatch(pool,lines,verdicts);
+        for (std::size_t i=0;i<lines.size();i++){
+            lineNumber++;
+            const Verdict& v=verdicts[i];
+            if (v.result==VerifyResult::Skipped) continue;
+            totals.submissions++;
+            totals.moves+=v.moves;
+            if (v.result==VerifyResult::Won) totals.won++;
+            if (v.result==VerifyResult::Won && !all) continue;
+
+            std::cout << name << ":" << lineNumber << ": " << verifyResultName(v.result);
+            if (v.result==VerifyResult::Illegal || v.result==VerifyResult::Unreadable){
+                std::cout << " " << v.moves << " '" << lines[i].substr(v.offset,v.length) << "'";
+            } else if (v.result!=VerifyResult::NoDeal){
+                std::cout << " after " << v.moves << " moves";
+            }
+            std::cout << "\n";
+        }
+        lines.clear();
+
+    }
+
+    ThreadPool pool;
+    bool all;
+    std::vector<std::string_view> lines;
+    std::vector<Verdict> verdicts;
+    std::uint64_t lineNumber=0;
+    Totals totals;
+
+};
+
+// -- Reads a stream in large blocks, handing over whole lines as they arrive
+bool verifyStream(std::FILE* in,const std::string& name,Run& run){
+
+    std::vector<char> buffer(readBytes);
+    std::size_t kept=0;
+    while (true){
+        if (kept==buffer.size()) buffer.resize(buffer.size()*2); // A line longer than the buffer
+        std::size_t got=std::fread(buffer.data()+kept,1,buffer.size()-kept,in);
+        bool last=got==0;
+        std::size_t size=kept+got;
+        std::size_t used=run.feed(std::string_view(buffer.data(),size),last,name);
+        kept=size-used;
+        std::copy(buffer.begin()+used,buffer.begin()+size,buffer.begin());
+        if (last) return !std::ferror(in);
+    }
+
+}
+
+}
+
+int main(int argc,char** argv){
+
+    int threads=0;
+    bool all=false;
+    std::vector<std::string> paths;
+    for (int i=1;i<argc;i++){
+        std::string arg=argv[i];
+        if (arg=="--threads" && i+1<argc) threads=std::atoi(argv[++i]);
+        else if (arg=="--all") all=true;
+        else if (arg.size()>1 && arg[0]=='-'){
+            std::cerr << "usage: solitaire-verify [--threads T] [--all] [file ...]\n";
+            return 1;
+        } else paths.push_back(arg);
+    }
+    if (paths.empty()) paths.push_back("-");
+
+    Run run(threads,all);
+    auto start=std::chrono::steady_clock::now();
+    for (const std::string& path : paths){
+        run.startFile();
+        if (path=="-"){
+            if (!verifyStream(stdin,"<stdin>",run)){
+                std::cerr << "solitaire-verify: error reading stdin\n";
+                return 1;
+            }
+            continue;
+        }
+        MappedFile file; // Whole files are mapped and verified in place
+        if (!file.open(path)){
+            std::ifstream probe(path);
+            if (probe && probe.peek()==std::ifstream::traits_type::eof()) continue; // Empty, nothing to verify
+            std::cerr << "solitaire-verify: can't read " << path << "\n";
+            return 1;
+        }
+        run.feed(std::string_view(reinterpret_cast<const char*>(file.data()),file.size()),true,path);
+    }
+    double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    const Totals& totals=run.getTotals();
+    std::uint64_t rejected=totals.submissions-totals.won;
+    std::cout << totals.submissions << " submissions, " << totals.won << " won, " << rejected << " rejected, "
+              << totals.moves << " moves in " << seconds << " s on " << run.threads() << " threads, "
+              << (seconds>0.0 ? totals.submissions/seconds : 0.0) << " verifications/sec, "
+              << (seconds>0.0 ? totals.moves/seconds/1e6 : 0.0) << " M moves/sec\n";
+    return rejected==0 ? 0 : 2;
+}